@@ -0,0 +1,72 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<uint64_t> totalAllocations{0};
+	// Constant-initialized, so that it can be used from operator new on any thread, before main() too
+	thread_local uint64_t threadAllocations = 0;
+
+	void* allocate(std::size_t size)
+	{
+		totalAllocations.fetch_add(1, std::memory_order_relaxed);
+		threadAllocations++;
+		return std::malloc(size > 0 ? size : 1);
+	}
+}
+
+uint64_t AllocationCounter::getTotal()
+{
+	return totalAllocations.load(std::memory_order_relaxed);
+}
+
+uint64_t AllocationCounter::getThisThread()
+{
+	return threadAllocations;
+}
+
+void* operator new(std::size_t size)
+{
+	auto pointer = allocate(size);
+	if (!pointer) throw std::bad_alloc();
+	return pointer;
+}
+
+void* operator new[](std::size_t size)
+{
+	auto pointer = allocate(size);
+	if (!pointer) throw std::bad_alloc();
+	return pointer;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
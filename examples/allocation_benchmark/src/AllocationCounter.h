@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Counts the calls to the global operator new, which this example replaces, in total and per thread.
+ */
+namespace AllocationCounter
+{
+	uint64_t getTotal();
+	uint64_t getThisThread();
+}
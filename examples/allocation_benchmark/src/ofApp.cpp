@@ -0,0 +1,129 @@
+#include "ofApp.h"
+#include <thread>
+#include "AllocationCounter.h"
+
+static std::string moduleName = "allocation_benchmark";
+
+static const std::size_t NumParameters = 100;
+static const std::size_t WarmupRounds = 200;
+static const std::size_t MeasuredRounds = 1000;
+static const int ServerInPort = 12040;
+static const uint64_t ConnectTimeoutMillis = 5000;
+
+void ofApp::setup()
+{
+	ofSetLogLevel(OF_LOG_WARNING);
+
+	serverGroup.setName("Benchmark");
+	serverValues.resize(NumParameters);
+	for (std::size_t i = 0; i < NumParameters; i++)
+	{
+		serverGroup.add(serverValues[i].set("value" + ofToString(i), 0, 0, 1));
+		paths.push_back("/Benchmark/value" + ofToString(i));
+	}
+	valueTexts = {"0.25", "0.75"};
+
+	if (!connect())
+	{
+		ofLogError(moduleName) << "Timed out waiting for the model from the Server";
+		ofExit(1);
+		return;
+	}
+
+	StageAllocations warmup;
+	for (std::size_t round = 0; round < WarmupRounds; round++)
+	{
+		runRound(round, false, warmup);
+		runRound(round, true, warmup);
+	}
+
+	StageAllocations measured;
+	for (std::size_t round = 0; round < MeasuredRounds; round++)
+	{
+		runRound(round, false, measured);
+	}
+	for (std::size_t round = 0; round < MeasuredRounds; round++)
+	{
+		runRound(round, true, measured);
+	}
+
+	// The last round sent valueTexts[(MeasuredRounds - 1) % 2] to every parameter:
+	auto expected = ofToFloat(valueTexts[(MeasuredRounds - 1) % 2]);
+	std::size_t applied = 0;
+	for (auto& value : serverValues)
+	{
+		if (value.get() == expected) applied++;
+	}
+
+	double messages = MeasuredRounds * NumParameters;
+	std::cout << "{\"parameters\": " << NumParameters
+			  << ", \"messagesPerStage\": " << MeasuredRounds * NumParameters
+			  << ", \"allocationsPerMessage\": {"
+			  << "\"clientSend\": " << measured.clientSend / messages
+			  << ", \"serverReceive\": " << measured.serverReceive / messages
+			  << ", \"serverApply\": " << measured.serverApply / messages
+			  << ", \"clientParameterSet\": " << measured.clientParameterSet / messages
+			  << "}, \"lastRoundApplied\": " << applied << "}\n";
+
+	server.close();
+	ofExit(0);
+}
+
+bool ofApp::connect()
+{
+	server.setup(serverGroup, ServerInPort, ServerInPort + 1);
+	server.setAutoUpdate(false);
+
+	client.setAutoUpdate(false);
+	// Heartbeats would be counted as allocations of the stages they happen to fall in:
+	client.setHeartbeat(0, ofxRemoteParameters::DefaultHeartbeatTimeoutMillis);
+	client.setup(clientGroup, "127.0.0.1", ServerInPort, ServerInPort + 1);
+	modelLoadedListener = client.modelLoadedEvent.newListener([this]() {
+		modelLoaded = true;
+	});
+	client.connect();
+
+	auto start = ofGetElapsedTimeMillis();
+	while (!modelLoaded && ofGetElapsedTimeMillis() - start < ConnectTimeoutMillis)
+	{
+		server.update();
+		client.poll(10);
+	}
+	return modelLoaded && clientGroup.size() == NumParameters;
+}
+
+void ofApp::runRound(std::size_t round, bool viaParameters, StageAllocations& allocations)
+{
+	auto& valueText = valueTexts[round % 2];
+	auto value = ofToFloat(valueText);
+
+	auto totalBefore = AllocationCounter::getTotal();
+	auto threadBefore = AllocationCounter::getThisThread();
+	for (std::size_t i = 0; i < NumParameters; i++)
+	{
+		if (viaParameters)
+		{
+			clientGroup.get(i).cast<float>().set(value);
+		}
+		else
+		{
+			client.sendParameterValue(paths[i], valueText);
+		}
+	}
+	auto sendAllocations = AllocationCounter::getThisThread() - threadBefore;
+	if (viaParameters) allocations.clientParameterSet += sendAllocations;
+	else allocations.clientSend += sendAllocations;
+
+	// Lets the Server's network thread receive the whole round
+	std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+	auto updateBefore = AllocationCounter::getThisThread();
+	server.update();
+	auto threadAfter = AllocationCounter::getThisThread();
+	if (!viaParameters)
+	{
+		allocations.serverApply += threadAfter - updateBefore;
+		// Everything that wasn't allocated on this thread was allocated by the network threads:
+		allocations.serverReceive += (AllocationCounter::getTotal() - totalBefore) - (threadAfter - threadBefore);
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxRemoteParameters/Server.h"
+#include "ofxRemoteParameters/Client.h"
+
+/**
+ * Streams parameter values from a Client to a Server over loopback and counts the heap allocations per value on each
+ * stage of the way: encoding and sending on the Client, receiving on the Server's network thread, and applying the
+ * values in Server::update(). Once warmed up, all three should be zero. Setting a Client ofParameter is measured
+ * too, and includes the allocations that openFrameworks makes to notify its listeners.
+ */
+class ofApp : public ofBaseApp {
+
+public:
+	void setup();
+
+private:
+	/// Gives access to Client::sendParameterValue(), to measure the send path on its own
+	class BenchmarkClient : public ofxRemoteParameters::Client
+	{
+	public:
+		using Client::sendParameterValue;
+	};
+
+	struct StageAllocations
+	{
+		uint64_t clientSend = 0;
+		uint64_t serverReceive = 0;
+		uint64_t serverApply = 0;
+		uint64_t clientParameterSet = 0;
+	};
+
+	bool connect();
+	/**
+	 * @brief Sends one value for every parameter, then lets the Server apply them.
+	 * @param viaParameters Whether to set the Client ofParameters rather than call sendParameterValue().
+	 */
+	void runRound(std::size_t round, bool viaParameters, StageAllocations& allocations);
+
+	ofxRemoteParameters::Server server;
+	BenchmarkClient client;
+	ofParameterGroup serverGroup;
+	ofParameterGroup clientGroup;
+	std::vector<ofParameter<float>> serverValues;
+	std::vector<std::string> paths;
+	/// Two values per parameter, alternated so that every value sent is a change
+	std::vector<std::string> valueTexts;
+	ofEventListener modelLoadedListener;
+	bool modelLoaded = false;
+};
@@ -0,0 +1,27 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofApp.h"
+
+//========================================================================
+// Usage: load_generator [--paths N] [--rate HZ] [--duration SECONDS] [--fps FPS] [--port PORT] [--output FILE]
+int main(int argc, char* argv[])
+{
+	ofApp::Settings settings;
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		std::string option = argv[i];
+		std::string value = argv[i + 1];
+		if (option == "--paths") settings.numPaths = ofToInt(value);
+		else if (option == "--rate") settings.rateHz = ofToFloat(value);
+		else if (option == "--duration") settings.durationSeconds = ofToFloat(value);
+		else if (option == "--fps") settings.fps = ofToInt(value);
+		else if (option == "--port") settings.serverInPort = ofToInt(value);
+		else if (option == "--output") settings.outputPath = value;
+		else ofLogWarning("load_generator") << "Unknown option " << option;
+	}
+
+	// No window, so that the tool can run on headless CI machines:
+	auto window = std::make_shared<ofAppNoWindow>();
+	ofSetupOpenGL(window, 1024, 768, OF_WINDOW);
+	ofRunApp(std::make_shared<ofApp>(settings));
+}
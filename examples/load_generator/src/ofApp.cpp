@@ -0,0 +1,203 @@
+#include "ofApp.h"
+#include <fstream>
+
+static std::string moduleName = "load_generator";
+
+// Time allowed for in-flight values to be applied once sending stops:
+static const uint64_t DrainMicros = 1000000;
+static const uint64_t ConnectTimeoutMicros = 5000000;
+
+ofApp::ofApp(const Settings& settings) : settings(settings)
+{
+}
+
+void ofApp::setup()
+{
+	ofSetLogLevel(OF_LOG_WARNING);
+	ofSetFrameRate(settings.fps);
+
+	// Each path is an int, so that the sequence numbers survive the round trip through ofToString unchanged:
+	serverGroup.setName("Load Generator");
+	serverParameters.resize(settings.numPaths);
+	for (int i = 0; i < settings.numPaths; i++)
+	{
+		serverGroup.add(serverParameters[i].set("Path " + ofToString(i), -1, -1, std::numeric_limits<int>::max()));
+		serverListeners.push(serverParameters[i].newListener([this](int& sequence) {
+			valueApplied(sequence);
+		}));
+	}
+
+	server.setup(serverGroup, settings.serverInPort, settings.serverInPort + 1);
+	client.setup(clientGroup, "127.0.0.1", settings.serverInPort, settings.serverInPort + 1);
+	modelLoadedListener = client.modelLoadedEvent.newListener([this]() {
+		startRunning();
+	});
+
+	phaseStartMicros = ofGetElapsedTimeMicros();
+	client.connect();
+}
+
+void ofApp::startRunning()
+{
+	if (clientGroup.size() != static_cast<std::size_t>(settings.numPaths))
+	{
+		ofLogError(moduleName) << "The model has " << clientGroup.size() << " parameters, expected "
+							   << settings.numPaths;
+		ofExit(1);
+		return;
+	}
+
+	auto expectedSends = static_cast<std::size_t>(settings.numPaths * settings.rateHz * settings.durationSeconds);
+	sequencePath.reserve(expectedSends);
+	sendMicros.reserve(expectedSends);
+	applyMicros.reserve(expectedSends);
+	lastAppliedSequence.assign(settings.numPaths, -1);
+
+	// Spread the paths over one period so that they don't all fire on the same frame:
+	auto now = ofGetElapsedTimeMicros();
+	auto periodMicros = static_cast<uint64_t>(1000000 / settings.rateHz);
+	nextSendMicros.resize(settings.numPaths);
+	for (int i = 0; i < settings.numPaths; i++)
+	{
+		nextSendMicros[i] = now + periodMicros * i / settings.numPaths;
+	}
+
+	phase = Phase::Running;
+	phaseStartMicros = now;
+}
+
+void ofApp::update()
+{
+	auto elapsed = ofGetElapsedTimeMicros() - phaseStartMicros;
+	switch (phase)
+	{
+		case Phase::Connecting:
+			if (elapsed > ConnectTimeoutMicros)
+			{
+				ofLogError(moduleName) << "Timed out waiting for the model from the Server";
+				ofExit(1);
+			}
+			break;
+		case Phase::Running:
+			sendDueValues();
+			if (elapsed > settings.durationSeconds * 1000000)
+			{
+				phase = Phase::Draining;
+				phaseStartMicros = ofGetElapsedTimeMicros();
+			}
+			break;
+		case Phase::Draining:
+			if (elapsed > DrainMicros)
+			{
+				writeReport();
+				ofExit(0);
+			}
+			break;
+	}
+}
+
+void ofApp::sendDueValues()
+{
+	auto now = ofGetElapsedTimeMicros();
+	auto periodMicros = static_cast<uint64_t>(1000000 / settings.rateHz);
+	for (int i = 0; i < settings.numPaths; i++)
+	{
+		// Only one value per path per frame: the Client sends on every change, and setting the same parameter
+		// twice in a frame would only measure the Server's coalescing.
+		if (nextSendMicros[i] > now) continue;
+		nextSendMicros[i] += periodMicros;
+		if (nextSendMicros[i] < now) nextSendMicros[i] = now + periodMicros;
+
+		int sequence = nextSequence++;
+		sequencePath.push_back(i);
+		sendMicros.push_back(ofGetElapsedTimeMicros());
+		applyMicros.push_back(0);
+		clientGroup.get(i).cast<int>() = sequence;
+	}
+}
+
+void ofApp::valueApplied(int sequence)
+{
+	if (sequence < 0 || sequence >= static_cast<int>(applyMicros.size())) return;
+	applyMicros[sequence] = ofGetElapsedTimeMicros();
+	auto& last = lastAppliedSequence[sequencePath[sequence]];
+	last = std::max(last, sequence);
+}
+
+void ofApp::writeReport()
+{
+	std::vector<uint64_t> latencies;
+	latencies.reserve(sendMicros.size());
+	std::size_t superseded = 0;
+	std::size_t lost = 0;
+	for (std::size_t i = 0; i < sendMicros.size(); i++)
+	{
+		if (applyMicros[i] != 0)
+		{
+			latencies.push_back(applyMicros[i] - sendMicros[i]);
+		}
+		else if (lastAppliedSequence[sequencePath[i]] > static_cast<int>(i))
+		{
+			// A later value for the same path made it, so the Server coalesced this one away or it was dropped
+			// in transit. Either way the path ended up up-to-date.
+			superseded++;
+		}
+		else
+		{
+			lost++;
+		}
+	}
+	std::sort(latencies.begin(), latencies.end());
+
+	auto percentile = [&latencies](double p) -> uint64_t {
+		if (latencies.empty()) return 0;
+		auto index = static_cast<std::size_t>(std::ceil(p * latencies.size())) - 1;
+		return latencies[std::min(index, latencies.size() - 1)];
+	};
+
+	// Power-of-two buckets, keyed by their upper bound in microseconds:
+	std::map<uint64_t, std::size_t> histogram;
+	uint64_t sum = 0;
+	for (auto latency : latencies)
+	{
+		uint64_t bound = 1;
+		while (bound < latency) bound <<= 1;
+		histogram[bound]++;
+		sum += latency;
+	}
+
+	auto sent = sendMicros.size();
+	std::stringstream json;
+	json << "{\n";
+	json << "\t\"paths\": " << settings.numPaths << ",\n";
+	json << "\t\"rateHz\": " << settings.rateHz << ",\n";
+	json << "\t\"durationSeconds\": " << settings.durationSeconds << ",\n";
+	json << "\t\"fps\": " << settings.fps << ",\n";
+	json << "\t\"sent\": " << sent << ",\n";
+	json << "\t\"applied\": " << latencies.size() << ",\n";
+	json << "\t\"superseded\": " << superseded << ",\n";
+	json << "\t\"lost\": " << lost << ",\n";
+	json << "\t\"lossRatio\": " << (sent > 0 ? double(sent - latencies.size()) / sent : 0.0) << ",\n";
+	json << "\t\"latencyMicros\": {\n";
+	json << "\t\t\"mean\": " << (latencies.empty() ? 0 : sum / latencies.size()) << ",\n";
+	json << "\t\t\"p50\": " << percentile(0.5) << ",\n";
+	json << "\t\t\"p99\": " << percentile(0.99) << ",\n";
+	json << "\t\t\"p999\": " << percentile(0.999) << ",\n";
+	json << "\t\t\"max\": " << (latencies.empty() ? 0 : latencies.back()) << "\n";
+	json << "\t},\n";
+	json << "\t\"histogram\": [";
+	for (auto iter = histogram.begin(); iter != histogram.end(); ++iter)
+	{
+		json << (iter == histogram.begin() ? "\n" : ",\n");
+		json << "\t\t{\"upperMicros\": " << iter->first << ", \"count\": " << iter->second << "}";
+	}
+	json << "\n\t]\n";
+	json << "}\n";
+
+	std::cout << json.str();
+	if (!settings.outputPath.empty())
+	{
+		std::ofstream file(settings.outputPath);
+		file << json.str();
+	}
+}
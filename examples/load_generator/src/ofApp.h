@@ -0,0 +1,63 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxRemoteParameters/Server.h"
+#include "ofxRemoteParameters/Client.h"
+
+/**
+ * Drives a Server with a Client over loopback and measures the latency between a value being set on the Client and
+ * it being applied to the Server's ofParameter. Every sent value is a unique sequence number, so the apply listener
+ * on the Server side can look up when it was sent.
+ */
+class ofApp : public ofBaseApp {
+
+public:
+	struct Settings
+	{
+		int numPaths = 100;
+		float rateHz = 30;
+		float durationSeconds = 10;
+		int fps = 60;
+		int serverInPort = 12010;
+		std::string outputPath;
+	};
+
+	ofApp(const Settings& settings);
+	void setup();
+	void update();
+
+private:
+	enum class Phase
+	{
+		Connecting,
+		Running,
+		Draining
+	};
+
+	void startRunning();
+	void sendDueValues();
+	void valueApplied(int sequence);
+	void writeReport();
+
+	Settings settings;
+	Phase phase = Phase::Connecting;
+	uint64_t phaseStartMicros = 0;
+
+	ofxRemoteParameters::Server server;
+	ofxRemoteParameters::Client client;
+	ofParameterGroup serverGroup;
+	ofParameterGroup clientGroup;
+	std::vector<ofParameter<int>> serverParameters;
+	ofEventListeners serverListeners;
+	ofEventListener modelLoadedListener;
+
+	/// The time at which each path is due to send its next value
+	std::vector<uint64_t> nextSendMicros;
+	/// The path that sent each sequence number
+	std::vector<int> sequencePath;
+	std::vector<uint64_t> sendMicros;
+	std::vector<uint64_t> applyMicros;
+	/// The highest sequence number applied for each path, used to tell superseded values from lost ones
+	std::vector<int> lastAppliedSequence;
+	int nextSequence = 0;
+};
@@ -0,0 +1,92 @@
+#include "MemoryCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<std::size_t> liveBytes{0};
+	std::atomic<std::size_t> peakBytes{0};
+	/// Keeps the size of each allocation in front of it, with the alignment that operator new guarantees
+	const std::size_t HeaderSize = alignof(std::max_align_t);
+
+	void* allocate(std::size_t size)
+	{
+		auto block = static_cast<char*>(std::malloc(HeaderSize + size));
+		if (!block) return nullptr;
+		*reinterpret_cast<std::size_t*>(block) = size;
+		auto live = liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+		auto peak = peakBytes.load(std::memory_order_relaxed);
+		while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+		{
+		}
+		return block + HeaderSize;
+	}
+
+	void deallocate(void* pointer)
+	{
+		if (!pointer) return;
+		auto block = static_cast<char*>(pointer) - HeaderSize;
+		liveBytes.fetch_sub(*reinterpret_cast<std::size_t*>(block), std::memory_order_relaxed);
+		std::free(block);
+	}
+}
+
+std::size_t MemoryCounter::getLiveBytes()
+{
+	return liveBytes.load(std::memory_order_relaxed);
+}
+
+std::size_t MemoryCounter::getPeakBytes()
+{
+	return peakBytes.load(std::memory_order_relaxed);
+}
+
+void MemoryCounter::resetPeak()
+{
+	peakBytes.store(liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size)
+{
+	auto pointer = allocate(size);
+	if (!pointer) throw std::bad_alloc();
+	return pointer;
+}
+
+void* operator new[](std::size_t size)
+{
+	auto pointer = allocate(size);
+	if (!pointer) throw std::bad_alloc();
+	return pointer;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	deallocate(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	deallocate(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	deallocate(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+	deallocate(pointer);
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * Tracks the heap memory allocated through the global operator new, which this example replaces.
+ */
+namespace MemoryCounter
+{
+	/// The bytes currently allocated
+	std::size_t getLiveBytes();
+	/// The most bytes allocated at once since the last call to resetPeak()
+	std::size_t getPeakBytes();
+	void resetPeak();
+}
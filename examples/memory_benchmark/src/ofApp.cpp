@@ -0,0 +1,70 @@
+#include "ofApp.h"
+#include "MemoryCounter.h"
+
+static const std::size_t ParametersPerFixture = 10;
+static const std::size_t FixturesPerUniverse = 100;
+
+void ofApp::setup()
+{
+	ofSetLogLevel(OF_LOG_WARNING);
+
+	std::size_t numParameters = 100000;
+	createParameters(numParameters);
+	// Groups count as entries of the model too:
+	auto numEntries = numParameters + numParameters / ParametersPerFixture +
+					  numParameters / (ParametersPerFixture * FixturesPerUniverse);
+
+	auto treeBytes = MemoryCounter::getLiveBytes();
+	{
+		BenchmarkServer server;
+		server.setup(parameters, 12050, 12051);
+		auto setupBytes = MemoryCounter::getLiveBytes();
+
+		MemoryCounter::resetPeak();
+		auto model = server.createMetaModel();
+		auto peakBytes = MemoryCounter::getPeakBytes();
+		// What the Server keeps once the model has been sent:
+		auto retainedBytes = MemoryCounter::getLiveBytes() - model.capacity();
+
+		auto perParameter = [numParameters](std::size_t bytes)
+		{
+			return double(bytes) / numParameters;
+		};
+		std::cout << "{\"parameters\": " << numParameters
+				  << ", \"entries\": " << numEntries
+				  << ", \"modelBytes\": " << model.size()
+				  << ", \"treeBytesPerParameter\": " << perParameter(treeBytes)
+				  << ", \"setupBytesPerParameter\": " << perParameter(setupBytes - treeBytes)
+				  << ", \"retainedBytesPerParameter\": " << perParameter(retainedBytes - treeBytes)
+				  << ", \"parameterTableBytesPerParameter\": " << perParameter(server.getStats().parameterTableBytes)
+				  << ", \"serializationPeakBytesPerParameter\": " << perParameter(peakBytes - setupBytes)
+				  << "}\n";
+		server.close();
+	}
+	ofExit(0);
+}
+
+void ofApp::createParameters(std::size_t numParameters)
+{
+	// Shaped like a lighting rig: universes of fixtures with a few parameters each
+	parameters.setName("Rig");
+	auto numFixtures = numParameters / ParametersPerFixture;
+	values.reserve(numParameters);
+	fixtures.reserve(numFixtures);
+	ofParameterGroup universe;
+	for (std::size_t f = 0; f < numFixtures; f++)
+	{
+		if (f % FixturesPerUniverse == 0)
+		{
+			universe = ofParameterGroup("Universe " + ofToString(f / FixturesPerUniverse));
+			parameters.add(universe);
+		}
+		fixtures.emplace_back("Fixture " + ofToString(f));
+		for (std::size_t p = 0; p < ParametersPerFixture; p++)
+		{
+			values.emplace_back("Channel " + ofToString(p), ofRandom(1), 0, 1);
+			fixtures.back().add(values.back());
+		}
+		universe.add(fixtures.back());
+	}
+}
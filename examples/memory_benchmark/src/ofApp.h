@@ -0,0 +1,28 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxRemoteParameters/Server.h"
+
+/**
+ * Measures the memory that the Server needs, per parameter, to serve a tree of 100k parameters: what it keeps
+ * between frames, and the peak while it serializes the model.
+ */
+class ofApp : public ofBaseApp {
+
+public:
+	void setup();
+
+private:
+	/// Gives access to Server::createMetaModel()
+	class BenchmarkServer : public ofxRemoteParameters::Server
+	{
+	public:
+		using Server::createMetaModel;
+	};
+
+	void createParameters(std::size_t numParameters);
+
+	ofParameterGroup parameters;
+	std::vector<ofParameterGroup> fixtures;
+	std::vector<ofParameter<float>> values;
+};
@@ -0,0 +1,142 @@
+#include "ofApp.h"
+#include "ofxRemoteParameters/XmlWriter.h"
+
+static const int Repetitions = 5;
+static const std::size_t ParametersPerGroup = 100;
+static ofEventListeners domListeners;
+
+void ofApp::setup()
+{
+	ofSetLogLevel(OF_LOG_WARNING);
+
+	BenchmarkClient client;
+	ofParameterGroup clientGroup;
+	client.setup(clientGroup, "127.0.0.1", 12020, 12021);
+
+	std::cout << "[\n";
+	std::vector<std::size_t> sizes = {10000, 100000};
+	for (std::size_t i = 0; i < sizes.size(); i++)
+	{
+		auto model = createModel(sizes[i]);
+		uint64_t bestStreaming = std::numeric_limits<uint64_t>::max();
+		uint64_t bestDom = std::numeric_limits<uint64_t>::max();
+
+		for (int r = 0; r < Repetitions; r++)
+		{
+			auto start = ofGetElapsedTimeMicros();
+			client.parseModel(model);
+			bestStreaming = std::min(bestStreaming, ofGetElapsedTimeMicros() - start);
+
+			ofParameterGroup domGroup;
+			start = ofGetElapsedTimeMicros();
+			parseWithDom(model, domGroup);
+			bestDom = std::min(bestDom, ofGetElapsedTimeMicros() - start);
+		}
+
+		std::cout << "\t{\"parameters\": " << sizes[i]
+				  << ", \"modelBytes\": " << model.size()
+				  << ", \"streamingMillis\": " << bestStreaming / 1000.0
+				  << ", \"domMillis\": " << bestDom / 1000.0
+				  << ", \"speedup\": " << double(bestDom) / std::max<uint64_t>(bestStreaming, 1)
+				  << "}" << (i + 1 < sizes.size() ? ",\n" : "\n");
+	}
+	std::cout << "]\n";
+
+	ofExit(0);
+}
+
+std::string ofApp::createModel(std::size_t numParameters)
+{
+	ofxRemoteParameters::XmlWriter writer;
+	writer.openElement("ofxRemoteParameters");
+	writer.openElement("Parameters");
+	writer.openElement("Benchmark");
+	writer.attribute("type", "group");
+	writer.attribute("name", "Benchmark");
+	for (std::size_t i = 0; i < numParameters; i++)
+	{
+		if (i % ParametersPerGroup == 0)
+		{
+			if (i > 0) writer.closeElement();
+			auto groupIndex = ofToString(i / ParametersPerGroup);
+			writer.openElement("Group_" + groupIndex);
+			writer.attribute("type", "group");
+			writer.attribute("name", "Group " + groupIndex);
+		}
+		writer.openElement("Param_" + ofToString(i));
+		writer.attribute("type", "float");
+		writer.attribute("name", "Param " + ofToString(i));
+		writer.textElement("value", ofToString(ofRandom(1)));
+		writer.textElement("min", "0");
+		writer.textElement("max", "1");
+		writer.closeElement();
+	}
+	if (numParameters > 0) writer.closeElement();
+	writer.closeElement(); // Benchmark
+	writer.closeElement(); // Parameters
+	writer.openElement("Methods");
+	writer.openElement("set");
+	writer.attribute("uiName", "Set parameter");
+	writer.closeElement();
+	writer.closeElement();
+	writer.closeElement();
+	return writer.getString();
+}
+
+// The following is how the Client parsed models before it had a streaming parser.
+void ofApp::parseWithDom(const std::string& model, ofParameterGroup& group)
+{
+	domListeners.unsubscribeAll();
+	ofXml xml;
+	xml.parse(model);
+	auto paramsXml = xml.findFirst("//ofxRemoteParameters/Parameters");
+	if (paramsXml)
+	{
+		for (auto& child : paramsXml.getChildren())
+		{
+			auto type = child.getAttribute("type").getValue();
+			if (type == "group")
+			{
+				group.setName(child.getAttribute("name").getValue());
+				parseGroupWithDom(group, child);
+			}
+		}
+	}
+}
+
+void ofApp::parseGroupWithDom(ofParameterGroup& group, ofXml& groupXml)
+{
+	for (auto& child : groupXml.getChildren())
+	{
+		auto type = child.getAttribute("type").getValue();
+		auto name = child.getAttribute("name").getValue();
+		if (type != "group")
+		{
+			auto value = child.getChild("value").getValue();
+			std::string min, max;
+			if (auto node = child.getChild("min"))
+			{
+				min = node.getValue();
+			}
+			if (auto node = child.getChild("max"))
+			{
+				max = node.getValue();
+			}
+			auto param = ofParameter<float>(name, ofFromString<float>(value));
+			if (!min.empty() && !max.empty())
+			{
+				param.setMin(ofFromString<float>(min));
+				param.setMax(ofFromString<float>(max));
+			}
+			auto paramPtr = param.newReference();
+			domListeners.push(param.newListener([paramPtr](float& value) {}));
+			group.add(*paramPtr);
+		}
+		else
+		{
+			auto subGroup = ofParameterGroup(name);
+			parseGroupWithDom(subGroup, child);
+			group.add(subGroup);
+		}
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxRemoteParameters/Client.h"
+
+/**
+ * Measures how long the Client takes to turn a model into parameters, compared to building the same parameters by
+ * walking an ofXml DOM (the way the Client used to parse models).
+ */
+class ofApp : public ofBaseApp {
+
+public:
+	void setup();
+
+private:
+	/// Gives access to Client::parseModel()
+	class BenchmarkClient : public ofxRemoteParameters::Client
+	{
+	public:
+		using Client::parseModel;
+	};
+
+	std::string createModel(std::size_t numParameters);
+	void parseWithDom(const std::string& model, ofParameterGroup& group);
+	void parseGroupWithDom(ofParameterGroup& group, ofXml& groupXml);
+};
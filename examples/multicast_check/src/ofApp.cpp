@@ -0,0 +1,94 @@
+#include "ofApp.h"
+
+static std::string moduleName = "multicast_check";
+
+static const std::string GroupAddress = "239.255.0.1";
+static const int MulticastPort = 12062;
+static const int ServerInPort = 12060;
+static const uint64_t AnnounceIntervalMillis = 100;
+static const uint64_t TimeoutMillis = 5000;
+
+void ofApp::setup()
+{
+	ofSetLogLevel(OF_LOG_WARNING);
+
+	parameters.setName("Observed");
+	parameters.add(level.set("level", 0.25, 0, 1));
+	server.setup(parameters, ServerInPort, ServerInPort + 1);
+	server.setAutoUpdate(false);
+	observer.setAutoUpdate(false);
+	lateObserver.setAutoUpdate(false);
+	if (!server.startMulticast(GroupAddress, MulticastPort, AnnounceIntervalMillis) ||
+		!observer.setupObserver(observedParameters, GroupAddress, MulticastPort))
+	{
+		ofLogError(moduleName) << "Could not set up multicast on " << GroupAddress << ":" << MulticastPort;
+		ofExit(1);
+		return;
+	}
+
+	bool ok = true;
+	auto fail = [&ok](const std::string& check)
+	{
+		ofLogError(moduleName) << "Failed: " << check;
+		ok = false;
+	};
+
+	if (!runUntil([this]() { return observedLevelIs(observedParameters, 0.25); }, TimeoutMillis))
+	{
+		fail("the observer receives the announced model");
+	}
+
+	// While nothing changes, the announce repeats the model it already serialized:
+	auto before = server.getStats();
+	runUntil([this, &before]() { return server.getStats().modelAnnouncements >= before.modelAnnouncements + 5; },
+			 TimeoutMillis);
+	auto after = server.getStats();
+	if (after.modelAnnouncements < before.modelAnnouncements + 5 ||
+		after.serializedAnnouncements != before.serializedAnnouncements)
+	{
+		fail("unchanged models are announced without serializing them again (" +
+			 ofToString(after.serializedAnnouncements - before.serializedAnnouncements) + " of " +
+			 ofToString(after.modelAnnouncements - before.modelAnnouncements) + " serialized)");
+	}
+
+	level = 0.75;
+	if (!runUntil([this]() { return observedLevelIs(observedParameters, 0.75); }, TimeoutMillis))
+	{
+		fail("the observer receives the value update");
+	}
+
+	// The next announce must carry the new value, for the observers that join from now on:
+	lateObserverStarted = lateObserver.setupObserver(lateObservedParameters, GroupAddress, MulticastPort);
+	if (!lateObserverStarted ||
+		!runUntil([this]() { return observedLevelIs(lateObservedParameters, 0.75); }, TimeoutMillis))
+	{
+		fail("an observer that joins after a change gets the new value with the model");
+	}
+	if (server.getStats().serializedAnnouncements != after.serializedAnnouncements + 1)
+	{
+		fail("the model is serialized again once after a value changes");
+	}
+
+	server.close();
+	std::cout << (ok ? "OK" : "FAILED") << "\n";
+	ofExit(ok ? 0 : 1);
+}
+
+bool ofApp::runUntil(const std::function<bool()>& condition, uint64_t timeoutMillis)
+{
+	auto start = ofGetElapsedTimeMillis();
+	while (!condition())
+	{
+		if (ofGetElapsedTimeMillis() - start >= timeoutMillis) return false;
+		server.update();
+		observer.update();
+		if (lateObserverStarted) lateObserver.update();
+		ofSleepMillis(5);
+	}
+	return true;
+}
+
+bool ofApp::observedLevelIs(ofParameterGroup& group, float value) const
+{
+	return group.contains("level") && group.get("level").cast<float>().get() == value;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxRemoteParameters/Server.h"
+#include "ofxRemoteParameters/Client.h"
+
+/**
+ * Publishes a model to a multicast group on this machine and follows it with observers. Checks that an observer
+ * receives the announced model and the value updates, that the periodic announce reuses the previous model while
+ * nothing changes, and that an observer that joins after a change gets the new value with the model. Exits with a
+ * nonzero code if one of the checks fails.
+ */
+class ofApp : public ofBaseApp {
+
+public:
+	void setup();
+
+private:
+	/**
+	 * @brief Updates the Server and the observers until condition holds or the timeout passes.
+	 * @return Whether condition holds.
+	 */
+	bool runUntil(const std::function<bool()>& condition, uint64_t timeoutMillis);
+	bool observedLevelIs(ofParameterGroup& group, float value) const;
+
+	ofxRemoteParameters::Server server;
+	ofxRemoteParameters::Client observer;
+	ofxRemoteParameters::Client lateObserver;
+	ofParameterGroup parameters;
+	ofParameter<float> level;
+	ofParameterGroup observedParameters;
+	ofParameterGroup lateObservedParameters;
+	bool lateObserverStarted = false;
+};
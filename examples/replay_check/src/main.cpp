@@ -0,0 +1,11 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofApp.h"
+
+//========================================================================
+int main()
+{
+	auto window = std::make_shared<ofAppNoWindow>();
+	ofSetupOpenGL(window, 1024, 768, OF_WINDOW);
+	ofRunApp(std::make_shared<ofApp>());
+}
@@ -0,0 +1,90 @@
+#include "ofApp.h"
+#include <cstdio>
+#include "ofxRemoteParameters/TrafficLog.h"
+
+static std::string moduleName = "replay_check";
+
+static const int NumMessages = 50;
+static const uint64_t MessageIntervalMicros = 1000;
+static const int ServerInPort = 12050;
+static const uint64_t ReplayTimeoutMillis = 5000;
+
+void ofApp::setup()
+{
+	ofSetLogLevel(OF_LOG_WARNING);
+
+	parameters.setName("Replay");
+	parameters.add(counter.set("counter", -1, -1, NumMessages));
+	logPath = ofToDataPath("replay_check.ofxrplog", true);
+
+	bool ok = writeLog() && checkReplayer() && checkServerReplay();
+	std::remove(logPath.c_str());
+	std::cout << (ok ? "OK" : "FAILED") << "\n";
+	ofExit(ok ? 0 : 1);
+}
+
+bool ofApp::writeLog()
+{
+	ofxRemoteParameters::TrafficRecorder recorder;
+	if (!recorder.open(logPath)) return false;
+	for (int i = 0; i < NumMessages; i++)
+	{
+		ofxOscMessage message;
+		message.setAddress(ofxRemoteParameters::ApiRoot + "/" + ofxRemoteParameters::MethodSetParam);
+		message.addStringArg("/Replay/counter");
+		message.addStringArg(ofToString(i));
+		recorder.record(message, i * MessageIntervalMicros);
+	}
+	recorder.close();
+	return true;
+}
+
+bool ofApp::checkReplayer()
+{
+	ofxRemoteParameters::TrafficReplayer replayer;
+	if (!replayer.open(logPath)) return false;
+
+	ofxOscMessage message;
+	uint64_t timestamp;
+	int count = 0;
+	while (replayer.peekTimestamp(timestamp) && replayer.next(message, timestamp))
+	{
+		count++;
+	}
+	// At the end of the log, peeking must neither read past the mapping nor find another record:
+	if (count != NumMessages || replayer.getPosition() != replayer.getSize() || replayer.peekTimestamp(timestamp) ||
+		replayer.next(message, timestamp))
+	{
+		ofLogError(moduleName) << "TrafficReplayer read " << count << " of " << NumMessages << " records and stopped at "
+							   << replayer.getPosition() << " of " << replayer.getSize() << " bytes";
+		return false;
+	}
+	return true;
+}
+
+bool ofApp::checkServerReplay()
+{
+	server.setup(parameters, ServerInPort, ServerInPort + 1);
+	server.setAutoUpdate(false);
+	if (!server.startReplay(logPath, ofxRemoteParameters::Server::ReplayMode::RealTime)) return false;
+
+	auto start = ofGetElapsedTimeMillis();
+	while (server.isReplaying() && ofGetElapsedTimeMillis() - start < ReplayTimeoutMillis)
+	{
+		server.update();
+		ofSleepMillis(1);
+	}
+	bool finished = !server.isReplaying();
+	server.update();
+	server.close();
+
+	auto& stats = server.getReplayStats();
+	if (!finished || stats.messageCount != NumMessages || counter.get() != NumMessages - 1)
+	{
+		ofLogError(moduleName) << "The Server replay " << (finished ? "finished" : "did not finish") << " after "
+							   << stats.messageCount << " of " << NumMessages << " messages, counter is "
+							   << counter.get();
+		return false;
+	}
+	return true;
+}
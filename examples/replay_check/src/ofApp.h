@@ -0,0 +1,25 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxRemoteParameters/Server.h"
+
+/**
+ * Records a short traffic log, then replays it to its end: once with TrafficReplayer directly, and once through a
+ * Server in real time, which peeks past the last record to find out that the replay is over. Exits with a nonzero
+ * code if a replay doesn't stop at the end of the log or doesn't deliver every value.
+ */
+class ofApp : public ofBaseApp {
+
+public:
+	void setup();
+
+private:
+	bool writeLog();
+	bool checkReplayer();
+	bool checkServerReplay();
+
+	ofxRemoteParameters::Server server;
+	ofParameterGroup parameters;
+	ofParameter<int> counter;
+	std::string logPath;
+};
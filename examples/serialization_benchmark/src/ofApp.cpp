@@ -0,0 +1,81 @@
+#include "ofApp.h"
+#include <thread>
+
+static const int Repetitions = 5;
+static const std::size_t ParametersPerFixture = 10;
+static const std::size_t FixturesPerUniverse = 100;
+
+void ofApp::setup()
+{
+	ofSetLogLevel(OF_LOG_WARNING);
+
+	std::size_t numParameters = 50000;
+	createParameters(numParameters);
+	BenchmarkServer server;
+	server.setup(parameters, 12030, 12031);
+
+	std::vector<std::size_t> threadCounts = {1, 2, 4, 8};
+	auto cores = std::max(1u, std::thread::hardware_concurrency());
+	if (std::find(threadCounts.begin(), threadCounts.end(), cores) == threadCounts.end())
+	{
+		threadCounts.push_back(cores);
+	}
+
+	std::string reference;
+	uint64_t singleThreadMicros = 0;
+	std::cout << "[\n";
+	for (std::size_t i = 0; i < threadCounts.size(); i++)
+	{
+		server.setSerializationThreads(threadCounts[i]);
+		uint64_t best = std::numeric_limits<uint64_t>::max();
+		std::string model;
+		for (int r = 0; r < Repetitions; r++)
+		{
+			auto start = ofGetElapsedTimeMicros();
+			model = server.createMetaModel();
+			best = std::min(best, ofGetElapsedTimeMicros() - start);
+		}
+		if (i == 0)
+		{
+			reference = model;
+			singleThreadMicros = best;
+		}
+
+		std::cout << "\t{\"parameters\": " << numParameters
+				  << ", \"threads\": " << threadCounts[i]
+				  << ", \"modelBytes\": " << model.size()
+				  << ", \"millis\": " << best / 1000.0
+				  << ", \"speedup\": " << double(singleThreadMicros) / std::max<uint64_t>(best, 1)
+				  << ", \"identical\": " << (model == reference ? "true" : "false")
+				  << "}" << (i + 1 < threadCounts.size() ? ",\n" : "\n");
+	}
+	std::cout << "]\n";
+
+	server.close();
+	ofExit(0);
+}
+
+void ofApp::createParameters(std::size_t numParameters)
+{
+	// Shaped like a lighting rig: universes of fixtures with a few parameters each
+	parameters.setName("Rig");
+	auto numFixtures = numParameters / ParametersPerFixture;
+	values.reserve(numParameters);
+	fixtures.reserve(numFixtures);
+	ofParameterGroup universe;
+	for (std::size_t f = 0; f < numFixtures; f++)
+	{
+		if (f % FixturesPerUniverse == 0)
+		{
+			universe = ofParameterGroup("Universe " + ofToString(f / FixturesPerUniverse));
+			parameters.add(universe);
+		}
+		fixtures.emplace_back("Fixture " + ofToString(f));
+		for (std::size_t p = 0; p < ParametersPerFixture; p++)
+		{
+			values.emplace_back("Channel " + ofToString(p), ofRandom(1), 0, 1);
+			fixtures.back().add(values.back());
+		}
+		universe.add(fixtures.back());
+	}
+}
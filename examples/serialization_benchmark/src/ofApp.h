@@ -0,0 +1,28 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxRemoteParameters/Server.h"
+
+/**
+ * Measures how long the Server takes to serialize a large model with 1 to N threads, and checks that every thread
+ * count produces the same text.
+ */
+class ofApp : public ofBaseApp {
+
+public:
+	void setup();
+
+private:
+	/// Gives access to Server::createMetaModel()
+	class BenchmarkServer : public ofxRemoteParameters::Server
+	{
+	public:
+		using Server::createMetaModel;
+	};
+
+	void createParameters(std::size_t numParameters);
+
+	ofParameterGroup parameters;
+	std::vector<ofParameterGroup> fixtures;
+	std::vector<ofParameter<float>> values;
+};
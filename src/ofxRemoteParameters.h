@@ -5,6 +5,7 @@
 #ifndef OFXREMOTEPARAMETERS_OFXREMOTEPARAMETERS_H
 #define OFXREMOTEPARAMETERS_OFXREMOTEPARAMETERS_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -12,11 +13,32 @@ namespace ofxRemoteParameters
 {
 	const std::string ApiRoot = "/ofxrpMethod";
 	const std::string ApiResponse = "/ofxrpResponse";
+	/// Prefix of the calls that the Server acknowledges: /ofxrpReliable/(method)/(request id)
+	const std::string ApiReliable = "/ofxrpReliable";
 	const std::string MethodGetModel = "getModel";
 	const std::string MethodConnect = "connect";
 	const std::string MethodSetParam = "set";
+	/// Sets a parameter by the id that the model gives it, see ModelAttributeId
+	const std::string MethodSetById = "setById";
+	const std::string MethodClose = "close";
+	const std::string MethodHeartbeat = "heartbeat";
+	const std::string MethodSetRange = "setRange";
+	const std::string MethodGetValues = "getValues";
+	const std::string MethodGetTrace = "getTrace";
+	/// The response to a call through ApiReliable, with its request id
+	const std::string MethodAck = "ack";
+	/// The attribute of the parameters in the model with their id, for setById
+	const std::string ModelAttributeId = "id";
+	/// The attribute of the root group in the model with a key of the model identity, which setById calls must match
+	const std::string ModelAttributeModelKey = "modelKey";
+	/// Sent as the argument of getModel by clients that accept a compressed model
+	const std::string ModelEncodingDeflate = "deflate";
 	const int DefaultServerOutPort = 12001;
 	const int DefaultServerInPort = 12000;
+	const uint64_t DefaultHeartbeatIntervalMillis = 100;
+	const uint64_t DefaultHeartbeatTimeoutMillis = 400;
+	const uint64_t DefaultRetransmitMillis = 100;
+	const int DefaultMaxDeliveryAttempts = 10;
 
 	const int VersionMajor = 0;
 	const int VersionMinor = 1;
@@ -0,0 +1,242 @@
+//
+// Text and blob encodings for array parameters, and change tracking for partial updates.
+//
+
+#ifndef OFXREMOTEPARAMETERS_ARRAYTYPES_H
+#define OFXREMOTEPARAMETERS_ARRAYTYPES_H
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "ofFileUtils.h"
+#include "ofParameter.h"
+#include "ofVectorMath.h"
+
+namespace ofxRemoteParameters
+{
+	/**
+	 * @brief Identifies the array parameter types, ofParameter<std::vector<Element>> where Element is int, float or
+	 * a glm vector. These are (de)serialized by the addon rather than through ofToString(), and can be updated
+	 * partially with setRange messages.
+	 */
+	template<typename T>
+	struct ArrayTraits
+	{
+		static constexpr bool isArray = false;
+	};
+
+	template<typename Element>
+	struct ArrayTraits<std::vector<Element>>
+	{
+		static constexpr bool isArray = std::is_same<Element, int>::value ||
+										std::is_same<Element, float>::value ||
+										std::is_same<Element, glm::vec2>::value ||
+										std::is_same<Element, glm::vec3>::value ||
+										std::is_same<Element, glm::vec4>::value;
+		using ElementType = Element;
+	};
+
+	namespace priv
+	{
+		template<typename Element>
+		constexpr int componentCount()
+		{
+			if constexpr (std::is_arithmetic<Element>::value) return 1;
+			else return Element::length();
+		}
+
+		template<typename Element>
+		auto* components(Element& element)
+		{
+			if constexpr (std::is_arithmetic<Element>::value) return &element;
+			else return &element[0];
+		}
+	}
+
+	/**
+	 * @brief Encodes an array as text, for the model and for set messages: the components of all the elements,
+	 * separated by commas. "1,2,3,4" is an array of 4 floats or of 2 glm::vec2.
+	 */
+	template<typename Element>
+	std::string arrayToString(const std::vector<Element>& values)
+	{
+		std::string text;
+		text.reserve(values.size() * priv::componentCount<Element>() * 8);
+		char buffer[32];
+		for (auto element : values)
+		{
+			auto component = priv::components(element);
+			for (int i = 0; i < priv::componentCount<Element>(); i++)
+			{
+				if (!text.empty()) text += ',';
+				if constexpr (std::is_integral<Element>::value)
+				{
+					std::snprintf(buffer, sizeof(buffer), "%d", component[i]);
+				}
+				else
+				{
+					// Enough digits for the float to survive the round trip
+					std::snprintf(buffer, sizeof(buffer), "%.9g", component[i]);
+				}
+				text += buffer;
+			}
+		}
+		return text;
+	}
+
+	template<typename Element>
+	std::vector<Element> arrayFromString(const std::string& text)
+	{
+		std::vector<Element> values;
+		Element element{};
+		int componentIndex = 0;
+		const char* position = text.c_str();
+		while (*position != '\0')
+		{
+			char* end;
+			auto component = priv::components(element);
+			if constexpr (std::is_integral<Element>::value)
+			{
+				component[componentIndex] = static_cast<int>(std::strtol(position, &end, 10));
+			}
+			else
+			{
+				component[componentIndex] = std::strtof(position, &end);
+			}
+			if (end == position) break;
+			if (++componentIndex == priv::componentCount<Element>())
+			{
+				values.push_back(element);
+				componentIndex = 0;
+			}
+			position = end;
+			while (*position == ',' || *position == ' ') position++;
+		}
+		return values;
+	}
+
+	/**
+	 * @brief Encodes a range of elements as an OSC blob: their components as 32 bit values in host byte order, which
+	 * is little-endian on every platform that openFrameworks supports.
+	 */
+	template<typename Element>
+	ofBuffer arrayToBlob(const Element* values, std::size_t count)
+	{
+		return ofBuffer(reinterpret_cast<const char*>(values), count * sizeof(Element));
+	}
+
+	/**
+	 * @return false if the blob doesn't hold a whole number of elements.
+	 */
+	template<typename Element>
+	bool arrayFromBlob(const ofBuffer& blob, std::vector<Element>& values)
+	{
+		if (blob.size() % sizeof(Element) != 0) return false;
+		values.resize(blob.size() / sizeof(Element));
+		if (!values.empty()) std::memcpy(values.data(), blob.getData(), blob.size());
+		return true;
+	}
+
+	/**
+	 * @brief Overwrites count elements of the array, starting at offset, and notifies the parameter's listeners once.
+	 * The array grows if the range extends past its end, but the range must start within the array or right after
+	 * it: a range from the network can't make the array allocate more than the elements it carries.
+	 * @param notify false to set the array without notifying the listeners, e.g. during a transaction.
+	 * @return false, and leaves the parameter as it is, if offset is past the end of the array.
+	 */
+	template<typename Element>
+	bool writeRange(ofParameter<std::vector<Element>>& parameter,
+					std::size_t offset,
+					const Element* values,
+					std::size_t count,
+					bool notify = true)
+	{
+		auto array = parameter.get();
+		if (offset > array.size()) return false;
+		if (offset + count > array.size()) array.resize(offset + count);
+		std::copy(values, values + count, array.begin() + offset);
+		if (notify) parameter.set(array);
+		else parameter.setWithoutEventNotifications(array);
+		return true;
+	}
+
+	/**
+	 * @brief Keeps a copy of the last known contents of array parameters, to find the range that changed.
+	 * @tparam Key What identifies a parameter, e.g. its path.
+	 */
+	template<typename Key>
+	class ArrayShadows
+	{
+	public:
+		template<typename Element>
+		void set(const Key& key, const std::vector<Element>& values)
+		{
+			auto& shadow = shadows[key];
+			shadow.assign(reinterpret_cast<const char*>(values.data()),
+						  reinterpret_cast<const char*>(values.data() + values.size()));
+		}
+
+		/**
+		 * @brief Finds the elements of values that differ from the copy, and updates the copy.
+		 * @param offset Receives the index of the first element that changed.
+		 * @param count Receives the number of elements from offset up to the last one that changed. 0 if nothing
+		 * changed.
+		 * @return false if there was no copy or the size of the array changed, in which case the whole array should
+		 * be sent.
+		 */
+		template<typename Element>
+		bool diff(const Key& key, const std::vector<Element>& values, std::size_t& offset, std::size_t& count)
+		{
+			auto iter = shadows.find(key);
+			auto bytes = reinterpret_cast<const char*>(values.data());
+			auto byteCount = values.size() * sizeof(Element);
+			if (iter == shadows.end() || iter->second.size() != byteCount)
+			{
+				set(key, values);
+				return false;
+			}
+
+			auto& shadow = iter->second;
+			std::size_t first = 0;
+			while (first < values.size() &&
+				   std::memcmp(&shadow[first * sizeof(Element)], bytes + first * sizeof(Element), sizeof(Element)) == 0)
+			{
+				first++;
+			}
+			std::size_t last = values.size();
+			while (last > first &&
+				   std::memcmp(&shadow[(last - 1) * sizeof(Element)], bytes + (last - 1) * sizeof(Element),
+							   sizeof(Element)) == 0)
+			{
+				last--;
+			}
+			offset = first;
+			count = last - first;
+			if (count > 0)
+			{
+				std::memcpy(&shadow[first * sizeof(Element)], bytes + first * sizeof(Element), count * sizeof(Element));
+			}
+			return true;
+		}
+
+		void forget(const Key& key)
+		{
+			shadows.erase(key);
+		}
+
+		void clear()
+		{
+			shadows.clear();
+		}
+
+	private:
+		std::unordered_map<Key, std::vector<char>> shadows;
+	};
+}
+
+#endif //OFXREMOTEPARAMETERS_ARRAYTYPES_H
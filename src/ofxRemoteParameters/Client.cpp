@@ -1,6 +1,7 @@
 
+#include <algorithm>
+#include <random>
 #include <ofAppRunner.h>
-#include <ofXml.h>
 #include <ofQuaternion.h>
 #include <ofMatrix3x3.h>
 #include <ofMatrix4x4.h>
@@ -11,23 +12,18 @@ using namespace ofxRemoteParameters;
 
 const std::string Client::LogModuleName = "ofxRemoteParameters::Client";
 
+static const std::string SetParamAddress = ApiRoot + "/" + MethodSetParam;
+static const std::string SetRangeAddress = ApiRoot + "/" + MethodSetRange;
+static const std::string SetByIdAddress = ApiRoot + "/" + MethodSetById;
+/// A getModel request that hasn't been answered after this many heartbeat intervals is considered lost
+static const uint64_t ModelRequestTimeoutIntervals = 5;
+
 Client::Client()
 {
-	addParameterType<int>("int");
-	addParameterType<float>("float");
-	addParameterType<double>("double");
-	addParameterType<ofColor>("color");
-	addParameterType<ofFloatColor>("floatColor");
-	addParameterType<ofParameterGroup>("group");
-	addParameterType<std::string>("string");
-	addParameterType<bool>("boolean");
-	addParameterType<glm::vec2>("vec2");
-	addParameterType<glm::vec3>("vec3");
-	addParameterType<glm::vec4>("vec4");
-	addParameterType<ofRectangle>("ofRectangle");
-	addParameterType<ofQuaternion>("ofQuaternion");
-	addParameterType<ofMatrix3x3>("ofMatrix3x3");
-	addParameterType<ofMatrix4x4>("ofMatrix4x4");
+	addParameterTypes<BuiltinTypes>();
+	// A restarted Client must not reuse the request ids that the Server remembers from the previous one:
+	std::random_device randomDevice;
+	nextRequestId = randomDevice();
 }
 
 bool Client::setup(ofParameterGroup& parameterGroup, std::string serverAddress, int serverInPort, int serverOutPort)
@@ -56,19 +52,97 @@ bool Client::setup(ofParameterGroup& parameterGroup, std::string serverAddress,
 		return success;
 	}
 
-	loopListener = ofGetMainLoop()->loopEvent.newListener([this](){
-		ofxOscMessage message;
-		while(oscReceiver.hasWaitingMessages())
+	isSetUp = true;
+	updateLoopListener();
+	return success;
+}
+
+bool Client::setupObserver(ofParameterGroup& parameterGroup, const std::string& groupAddress, int port)
+{
+	this->parameterGroup = std::dynamic_pointer_cast<ofParameterGroup>(parameterGroup.newReference());
+	observer = true;
+	if (!multicastReceiver.setup(groupAddress, port)) return false;
+
+	isSetUp = true;
+	updateLoopListener();
+	return true;
+}
+
+bool Client::isObserver() const
+{
+	return observer;
+}
+
+void Client::setAutoUpdate(bool autoUpdate)
+{
+	this->autoUpdate = autoUpdate;
+	updateLoopListener();
+}
+
+void Client::updateLoopListener()
+{
+	if (autoUpdate && isSetUp)
+	{
+		loopListener = ofGetMainLoop()->loopEvent.newListener([this](){
+			receiveMessages();
+		});
+	}
+	else
+	{
+		loopListener.unsubscribe();
+	}
+}
+
+void Client::update()
+{
+	receiveMessages();
+}
+
+bool Client::poll(uint64_t timeoutMillis)
+{
+	if (!observer && keepConnected && heartbeatIntervalMillis > 0)
+	{
+		timeoutMillis = std::min(timeoutMillis, heartbeatIntervalMillis);
+	}
+	if (!unacknowledgedRequests.empty())
+	{
+		timeoutMillis = std::min(timeoutMillis, retransmitMillis);
+	}
+	bool received = observer ? multicastReceiver.waitForMessage(timeoutMillis)
+							 : oscReceiver.waitForMessage(timeoutMillis);
+	update();
+	return received;
+}
+
+void Client::receiveMessages()
+{
+	OFXRP_TRACE_SCOPE("Client::receiveMessages");
+	ofxOscMessage message;
+	if (observer)
+	{
+		while (multicastReceiver.getNextMessage(message))
 		{
-			oscReceiver.getNextMessage(message);
 			parseReceivedMessage(message);
 		}
+		return;
+	}
+
+	while(oscReceiver.hasWaitingMessages())
+	{
+		oscReceiver.getNextMessage(message);
+		parseReceivedMessage(message);
+	}
+	updateFilters.flush(ofGetElapsedTimeMicros(), [this](const std::string& path, const std::string& value)
+	{
+		sendParameterValue(path, value);
 	});
-	return success;
+	retransmitRequests();
+	updateConnection();
 }
 
 void Client::parseReceivedMessage(ofxOscMessage& m)
 {
+	OFXRP_TRACE_SCOPE("Client::parseReceivedMessage");
 	ofLogVerbose(LogModuleName) << "RECEIVED MESSAGE ----";
 	ofLogVerbose(LogModuleName) << "address = " << m.getAddress();
 	for (int i = 0; i < m.getNumArgs(); i++)
@@ -86,21 +160,85 @@ void Client::parseReceivedMessage(ofxOscMessage& m)
 	// Only pay attention to messages that are responses:
 	if (components[1] == ApiResponse.substr(1))
 	{
+		lastResponseMillis = ofGetElapsedTimeMillis();
+
 		// Handle Connect:
 		if (components[2] == MethodConnect)
 		{
 			// Call connect, set vars
-			isConnected = true;
-			downloadModel();
-
+			connected = true;
+			backoffMillis = minBackoffMillis;
+			serverHasHeartbeat = m.getNumArgs() > 1;
+			if (serverHasHeartbeat && hasModel && m.getArgAsString(1) == modelIdentity)
+			{
+				ofLogNotice(LogModuleName) << "Reconnected to the Server, the model has not changed";
+			}
+			else if (!isModelRequestPending())
+			{
+				downloadModel();
+			}
+			connectedEvent.notify();
+		}
+		// Handle the acks of the calls sent with acknowledged delivery:
+		else if (components[2] == MethodAck)
+		{
+			if (m.getNumArgs() > 0) acknowledgeRequest(m.getArgAsInt32(0));
+		}
+		// Handle heartbeat:
+		else if (components[2] == MethodHeartbeat)
+		{
+			// The model changed without being pushed to us, or its push or the reply to our request was lost:
+			if (m.getNumArgs() > 0 && (!hasModel || m.getArgAsString(0) != modelIdentity) && !isModelRequestPending())
+			{
+				downloadModel();
+			}
+		}
+		// Handle values pushed by the Server:
+		else if (components[2] == MethodSetParam)
+		{
+			if (hasModel && m.getNumArgs() == 2)
+			{
+				applyServerValue(m.getArgAsString(0), m.getArgAsString(1));
+			}
+		}
+		else if (components[2] == MethodGetValues)
+		{
+			if (hasModel) applyServerValues(m);
+		}
+		else if (components[2] == MethodSetRange)
+		{
+			if (hasModel && m.getNumArgs() == 3 && m.getArgType(2) == OFXOSC_TYPE_BLOB)
+			{
+				applyServerRange(m.getArgAsString(0), m.getArgAsInt32(1), m.getArgAsBlob(2));
+			}
 		}
 		// Handle getModel:
 		else if (components[2] == MethodGetModel)
 		{
 			// Parse XML, populate group
-			if (isConnected)
+			if (observer)
+			{
+				// The model is announced periodically, but only needs to be parsed when it changes:
+				auto identity = m.getNumArgs() > 1 ? m.getArgAsString(1) : "";
+				std::string model;
+				if ((!hasModel || identity.empty() || identity != modelIdentity) && getModelText(m, model))
+				{
+					modelIdentity = identity;
+					parseModel(model);
+					hasModel = true;
+				}
+			}
+			else if (connected)
 			{
-				parseModel(m.getArgAsString(0));
+				modelRequested = false;
+				std::string model;
+				if (getModelText(m, model))
+				{
+					modelIdentity = m.getNumArgs() > 1 ? m.getArgAsString(1) : "";
+					parseModel(model);
+					updateFilters.clear();
+					hasModel = true;
+				}
 			}
 			else
 			{
@@ -115,102 +253,270 @@ void Client::parseReceivedMessage(ofxOscMessage& m)
 }
 
 void Client::connect()
+{
+	if (observer)
+	{
+		ofLogError(LogModuleName) << "connect() can't be called on an observer";
+		return;
+	}
+	keepConnected = true;
+	backoffMillis = minBackoffMillis;
+	nextConnectMillis = ofGetElapsedTimeMillis() + backoffMillis;
+	sendConnect();
+}
+
+void Client::disconnect()
+{
+	keepConnected = false;
+	connected = false;
+}
+
+bool Client::isConnected() const
+{
+	return connected;
+}
+
+void Client::setHeartbeat(uint64_t intervalMillis, uint64_t timeoutMillis)
+{
+	heartbeatIntervalMillis = intervalMillis;
+	heartbeatTimeoutMillis = timeoutMillis;
+}
+
+void Client::setAutoReconnect(bool autoReconnect, uint64_t minBackoffMillis, uint64_t maxBackoffMillis)
+{
+	this->autoReconnect = autoReconnect;
+	this->minBackoffMillis = minBackoffMillis;
+	this->maxBackoffMillis = std::max(minBackoffMillis, maxBackoffMillis);
+}
+
+void Client::sendConnect()
 {
 	ofxOscMessage message;
 	message.setAddress(ApiRoot + "/" + MethodConnect);
 	message.addStringArg("");
-	oscSender.sendMessage(message, false);
+	oscSender.sendMessage(message);
+}
+
+void Client::updateConnection()
+{
+	if (!keepConnected) return;
+	auto now = ofGetElapsedTimeMillis();
+
+	if (connected)
+	{
+		if (!serverHasHeartbeat || heartbeatIntervalMillis == 0) return;
+		if (now - lastResponseMillis > heartbeatTimeoutMillis)
+		{
+			ofLogWarning(LogModuleName) << "Lost connection to the Server";
+			connected = false;
+			// A model request in flight is lost with the connection:
+			modelRequested = false;
+			backoffMillis = minBackoffMillis;
+			nextConnectMillis = now;
+			connectionLostEvent.notify();
+		}
+		else if (now - lastHeartbeatMillis >= heartbeatIntervalMillis)
+		{
+			lastHeartbeatMillis = now;
+			ofxOscMessage message;
+			message.setAddress(ApiRoot + "/" + MethodHeartbeat);
+			oscSender.sendMessage(message);
+			return;
+		}
+	}
+
+	if (!connected && autoReconnect && now >= nextConnectMillis)
+	{
+		ofLogVerbose(LogModuleName) << "Trying to reconnect, next attempt in " << backoffMillis << " ms";
+		sendConnect();
+		nextConnectMillis = now + backoffMillis;
+		backoffMillis = std::min(backoffMillis * 2, maxBackoffMillis);
+	}
 }
 
 void Client::downloadModel()
 {
+	if (modelRequested)
+	{
+		ofLogWarning(LogModuleName) << "The model requested from the Server didn't arrive, requesting it again";
+	}
+	modelRequested = true;
+	modelRequestMillis = ofGetElapsedTimeMillis();
 	ofxOscMessage message;
 	message.setAddress(ApiRoot + "/" + MethodGetModel);
-	oscSender.sendMessage(message, false);
+	if (modelCompression) message.addStringArg(ModelEncodingDeflate);
+	oscSender.sendMessage(message);
 }
 
-void Client::parseModel(const std::string& xmlModel)
+bool Client::isModelRequestPending() const
 {
-	ofXml xml;
-	xml.parse(xmlModel);
-	auto paramsXml = xml.findFirst("//ofxRemoteParameters/Parameters");
-	if (paramsXml)
+	if (!modelRequested) return false;
+	// The model is large and travels over UDP, so the reply can be lost while the heartbeats get through:
+	auto interval = heartbeatIntervalMillis > 0 ? heartbeatIntervalMillis : DefaultHeartbeatIntervalMillis;
+	auto timeout = std::max(ModelRequestTimeoutIntervals * interval, heartbeatTimeoutMillis);
+	return ofGetElapsedTimeMillis() - modelRequestMillis < timeout;
+}
+
+/**
+ * @brief Rebuilds the parameter group while the model is being parsed.
+ */
+class Client::ModelBuilder : public ModelHandler
+{
+public:
+	ModelBuilder(Client& client) : client(client)
+	{
+	}
+
+	void parametersBegin() override
 	{
-		while(parameterGroup->size() > 0)
+		while (client.parameterGroup->size() > 0)
 		{
-			parameterGroup->remove(parameterGroup->size()-1);
+			client.parameterGroup->remove(client.parameterGroup->size() - 1);
 		}
 
-		paramListeners.unsubscribeAll();
+		client.paramListeners.unsubscribeAll();
+		client.arrayShadows.clear();
+		client.valueIndex.clear();
+		client.valueIndexRanges.clear();
+	}
 
-		// There should be only one child here, and it should be a group
-		for (auto& child : paramsXml.getChildren())
+	void groupBegin(const ModelParameter& group) override
+	{
+		paths.push_back((paths.empty() ? "" : paths.back()) + "/" + group.escapedName);
+		groupStarts.push_back(client.valueIndex.size());
+		if (groups.empty())
 		{
-			// Should be "group"
-			auto type = child.getAttribute("type").getValue();
-			if (type == "group")
-			{
-				parameterGroup->setName(child.getAttribute("name").getValue());
-				parseGroup(parameterGroup->castGroup(), child);
-			}
+			// There should be only one root group
+			client.parameterGroup->setName(group.name);
+			groups.push_back(*client.parameterGroup);
+			auto modelKey = group.getAttribute(ModelAttributeModelKey);
+			client.modelKey = modelKey ? ofToInt(*modelKey) : 0;
+		}
+		else
+		{
+			// ofParameterGroup copies share their contents, so the group can be filled after it has been added
+			ofParameterGroup subGroup(group.name);
+			groups.back().add(subGroup);
+			groups.push_back(subGroup);
 		}
 	}
 
-	// Parse Methods
-	auto methodsXml = xml.findFirst("//ofxRemoteParameters/Methods");
-	if (methodsXml)
+	void groupEnd() override
 	{
+		client.valueIndexRanges[paths.back()] = {groupStarts.back(), client.valueIndex.size()};
+		groups.pop_back();
+		paths.pop_back();
+		groupStarts.pop_back();
+	}
 
+	void parameter(const ModelParameter& parameter) override
+	{
+		// Parameters outside of the root group are ignored
+		if (groups.empty()) return;
+		auto path = paths.back() + "/" + parameter.escapedName;
+		auto index = client.valueIndex.size();
+		client.valueIndexRanges[path] = {index, index + 1};
+		auto id = parameter.getAttribute(ModelAttributeId);
+		client.valueIndex.push_back({client.addParameter(groups.back(), parameter, path), std::move(path),
+									 id ? ofToInt(*id) : -1});
+	}
+
+private:
+	Client& client;
+	std::vector<ofParameterGroup> groups;
+	std::vector<std::string> paths;
+	std::vector<std::size_t> groupStarts;
+};
+
+bool Client::getModelText(const ofxOscMessage& message, std::string& model)
+{
+	if (message.getNumArgs() == 0) return false;
+	if (message.getArgType(0) != OFXOSC_TYPE_BLOB)
+	{
+		model = message.getArgAsString(0);
+		return true;
+	}
+	if (!ModelCompression::decompress(message.getArgAsBlob(0), model))
+	{
+		ofLogError(LogModuleName) << "Could not decompress the model received from the Server";
+		return false;
+	}
+	return true;
+}
+
+void Client::setModelCompression(bool enabled)
+{
+	modelCompression = enabled;
+}
+
+void Client::parseModel(const std::string& xmlModel)
+{
+	OFXRP_TRACE_SCOPE("Client::parseModel");
+	ModelBuilder builder(*this);
+	if (!modelParser.parse(xmlModel, builder))
+	{
+		ofLogError(LogModuleName) << "The model received from the Server is malformed";
 	}
 	modelLoadedEvent.notify();
 }
 
-void Client::parseGroup(ofParameterGroup& paramGroup, ofXml& groupXml)
+std::shared_ptr<ofAbstractParameter> Client::addParameter(ofParameterGroup& paramGroup,
+														  const ModelParameter& modelParameter,
+														  const std::string& path)
 {
+	auto& type = modelParameter.type;
+	auto constructor = typeConstructors.find(type);
+	auto builtinType = builtinTypeIds.find(type);
+	if (constructor == typeConstructors.end() && builtinType == builtinTypeIds.end())
+	{
+		ofLogWarning(LogModuleName) << "Type not found: " << type;
+		return nullptr;
+	}
 
-	for (auto& child : groupXml.getChildren())
+	auto& name = modelParameter.name;
+	auto& value = modelParameter.value;
+	auto& min = modelParameter.min;
+	auto& max = modelParameter.max;
+	std::shared_ptr<ofAbstractParameter> paramPtr;
+	if (constructor != typeConstructors.end())
 	{
-		auto type = child.getAttribute("type").getValue();
-		try
+		paramPtr = constructor->second(name, path, value, min, max, paramListeners);
+	}
+	else
+	{
+		dispatchBuiltinType(builtinType->second, [&](auto tag)
 		{
-			auto tc = typeConstructors.at(type);
-			auto name = child.getAttribute("name").getValue();
-			if (type != "group")
-			{
-				auto value = child.getChild("value").getValue();
-				std::string min, max;
-				if (auto node = child.getChild("min"))
-				{
-					min = node.getValue();
-				}
+			using ParameterType = typename decltype(tag)::type;
+			paramPtr = createParameter<ParameterType>(name, path, value, min, max, paramListeners);
+		});
+	}
+	paramGroup.add(*paramPtr);
 
-				if (auto node = child.getChild("max"))
-				{
-					max = node.getValue();
-				}
-				auto paramPtr = tc(name, value, min, max, paramListeners);
-				paramGroup.add(*paramPtr);
-			}
-			else
+	if (builtinType != builtinTypeIds.end())
+	{
+		dispatchBuiltinType(builtinType->second, [&](auto tag)
+		{
+			using ParameterType = typename decltype(tag)::type;
+			if constexpr (ArrayTraits<ParameterType>::isArray)
 			{
-				auto subGroup = ofParameterGroup(name);
-				parseGroup(subGroup, child);
-				paramGroup.add(subGroup);
+				// The Server has this value, so edits only need to send the range that changes:
+				auto& typedParameter = static_cast<ofParameter<ParameterType>&>(*paramPtr);
+				arrayShadows.set(path, typedParameter.get());
 			}
-
-		}
-		catch (std::out_of_range& range)
-		{
-			ofLogWarning(LogModuleName) << "Type not found: " << type;
-		}
-
+		});
 	}
+	return paramPtr;
 }
 
 void Client::setRemoteParameter(std::shared_ptr<ofAbstractParameter> p)
+{
+	sendParameterValue(getParameterPath(*p), p->toString());
+}
+
+std::string Client::getParameterPath(const ofAbstractParameter& p) const
 {
 	std::stringstream paramPath;
-	auto names = p->getGroupHierarchyNames();
+	auto names = p.getGroupHierarchyNames();
 	auto index = ofFind(names, parameterGroup->getEscapedName());
 
 	// ofxGui inserts an ofParameterGroup as a parent of any group you pass it,
@@ -219,15 +525,187 @@ void Client::setRemoteParameter(std::shared_ptr<ofAbstractParameter> p)
 	{
 		paramPath << "/" << names[i];
 	}
+	return paramPath.str();
+}
 
+void Client::sendParameterValue(const std::string& path, const std::string& value)
+{
+	if (observer) return;
+	OFXRP_TRACE_SCOPE("Client::sendParameterValue");
+	if (isReliable(path))
+	{
+		ofxOscMessage message;
+		message.setAddress(SetParamAddress);
+		message.addStringArg(path);
+		message.addStringArg(value);
+		sendReliably(MethodSetParam, message);
+		return;
+	}
+	// No logging here: even a filtered out ofLog copies its module name, and this runs on every change
+	auto range = valueIndexRanges.find(path);
+	if (range != valueIndexRanges.end() && range->second.second == range->second.first + 1 &&
+		valueIndex[range->second.first].id >= 0)
+	{
+		// A few bytes instead of the path, and the Server doesn't have to look the path up
+		packetWriter.begin(SetByIdAddress).addInt32(modelKey).addInt32(valueIndex[range->second.first].id);
+		packetWriter.addString(value);
+	}
+	else
+	{
+		packetWriter.begin(SetParamAddress).addString(path).addString(value);
+	}
+	oscSender.send(packetWriter);
+}
+
+void Client::sendParameterRange(const std::string& path, std::size_t offset, const ofBuffer& values)
+{
+	if (observer) return;
+	OFXRP_TRACE_SCOPE("Client::sendParameterRange");
+	if (isReliable(path))
+	{
+		ofxOscMessage message;
+		message.setAddress(SetRangeAddress);
+		message.addStringArg(path);
+		message.addInt32Arg(static_cast<int32_t>(offset));
+		message.addBlobArg(values);
+		sendReliably(MethodSetRange, message);
+		return;
+	}
+	packetWriter.begin(SetRangeAddress).addString(path).addInt32(static_cast<int32_t>(offset));
+	packetWriter.addBlob(values.getData(), values.size());
+	oscSender.send(packetWriter);
+}
+
+void Client::setUpdateFilter(const std::string& pathPattern, const UpdateFilter& filter)
+{
+	updateFilters.setPathFilter(pathPattern, filter);
+}
+
+const UpdateFilter* Client::findUpdateFilter(const std::string& path, const ofAbstractParameter& parameter) const
+{
+	auto filter = updateFilters.findPathFilter(path);
+	if (filter) return filter;
+	auto typeFilter = typeUpdateFilters.find(std::type_index(typeid(parameter)));
+	if (typeFilter != typeUpdateFilters.end() && typeFilter->second.isActive()) return &typeFilter->second;
+	return nullptr;
+}
+
+std::shared_ptr<ofAbstractParameter> Client::findParameter(const std::string& path)
+{
+	auto pathComponents = ofSplitString(path, "/", true, true);
+	if (pathComponents.size() < 2 || pathComponents[0] != parameterGroup->getEscapedName()) return nullptr;
+
+	auto current = parameterGroup;
+	std::shared_ptr<ofAbstractParameter> parameter;
+	for (std::size_t i = 1; i < pathComponents.size(); i++)
+	{
+		if (!current) return nullptr;
+		auto iter = std::find_if(current->begin(), current->end(), [&](const std::shared_ptr<ofAbstractParameter>& child)
+		{
+			return child->getEscapedName() == pathComponents[i];
+		});
+		if (iter == current->end()) return nullptr;
+		parameter = *iter;
+		current = std::dynamic_pointer_cast<ofParameterGroup>(parameter);
+	}
+	return parameter;
+}
+
+void Client::applyServerValue(const std::string& path, const std::string& value)
+{
+	auto parameter = findParameter(path);
+	if (!parameter)
+	{
+		ofLogVerbose(LogModuleName) << "Received a value for an unknown parameter: " << path;
+		return;
+	}
+	applyServerValue(parameter, path, value);
+}
+
+void Client::applyServerValue(const std::shared_ptr<ofAbstractParameter>& parameter,
+							  const std::string& path,
+							  const std::string& value)
+{
+	applyingServerValue = true;
+	bool isArray = false;
+	forEachType(ArrayTypes(), [&](auto tag)
+	{
+		using ParameterType = typename decltype(tag)::type;
+		auto typedParameter = std::dynamic_pointer_cast<ofParameter<ParameterType>>(parameter);
+		if (!typedParameter) return;
+		isArray = true;
+		typedParameter->set(valueFromString<ParameterType>(value));
+		arrayShadows.set(path, typedParameter->get());
+	});
+	if (!isArray) parameter->fromString(value);
+	applyingServerValue = false;
+	// The Server has this value now, so the next change has to be compared against it:
+	updateFilters.forget(path);
+}
+
+void Client::applyServerRange(const std::string& path, int32_t offset, const ofBuffer& values)
+{
+	auto parameter = findParameter(path);
+	if (!parameter || offset < 0)
+	{
+		ofLogVerbose(LogModuleName) << "Received a range for an unknown parameter: " << path;
+		return;
+	}
+	applyingServerValue = true;
+	forEachType(ArrayTypes(), [&](auto tag)
+	{
+		using ParameterType = typename decltype(tag)::type;
+		auto typedParameter = std::dynamic_pointer_cast<ofParameter<ParameterType>>(parameter);
+		if (!typedParameter) return;
+		std::vector<typename ArrayTraits<ParameterType>::ElementType> elements;
+		if (!arrayFromBlob(values, elements))
+		{
+			ofLogWarning(LogModuleName) << "Received a range of the wrong size for " << path;
+			return;
+		}
+		if (!writeRange(*typedParameter, offset, elements.data(), elements.size()))
+		{
+			ofLogWarning(LogModuleName) << "Received a range at offset " << offset << ", past the end of " << path;
+			return;
+		}
+		arrayShadows.set(path, typedParameter->get());
+	});
+	applyingServerValue = false;
+}
+
+void Client::requestValues(const std::string& subtreePath)
+{
 	ofxOscMessage message;
-	message.setAddress(ApiRoot + "/" + MethodSetParam);
-	message.addStringArg(paramPath.str());
-	message.addStringArg(p->toString());
+	message.setAddress(ApiRoot + "/" + MethodGetValues);
+	message.addStringArg(subtreePath);
+	oscSender.sendMessage(message);
+}
 
-	ofLogVerbose(LogModuleName) << " Setting param: " << paramPath.str() << " " << p->toString();
+void Client::applyServerValues(ofxOscMessage& message)
+{
+	if (message.getNumArgs() < 2) return;
+	if (message.getArgAsString(0) != modelIdentity)
+	{
+		// The values follow a model that we don't have:
+		if (!isModelRequestPending() && !observer) downloadModel();
+		return;
+	}
 
-	oscSender.sendMessage(message, false);
+	auto rangeIter = valueIndexRanges.find(message.getArgAsString(1));
+	if (rangeIter == valueIndexRanges.end() ||
+		rangeIter->second.second - rangeIter->second.first != message.getNumArgs() - 2)
+	{
+		ofLogWarning(LogModuleName) << "The values received for " << message.getArgAsString(1)
+									<< " don't match the model";
+		return;
+	}
+	for (auto i = rangeIter->second.first; i < rangeIter->second.second; i++)
+	{
+		auto& entry = valueIndex[i];
+		if (!entry.parameter) continue;
+		applyServerValue(entry.parameter, entry.path, message.getArgAsString(2 + i - rangeIter->second.first));
+	}
+	valuesReceivedEvent.notify();
 }
 
 void Client::callServerMethod(const std::string& methodName)
@@ -235,5 +713,124 @@ void Client::callServerMethod(const std::string& methodName)
 	ofxOscMessage message;
 	message.setAddress(ApiRoot + "/" + methodName);
 	ofLogVerbose(LogModuleName) << "Calling server method: " << methodName;
-	oscSender.sendMessage(message, false);
-}
\ No newline at end of file
+	oscSender.sendMessage(message);
+}
+
+void Client::callServerMethodReliably(const std::string& methodName)
+{
+	ofxOscMessage message;
+	message.setAddress(ApiRoot + "/" + methodName);
+	ofLogVerbose(LogModuleName) << "Calling server method with acknowledged delivery: " << methodName;
+	sendReliably(methodName, message);
+}
+
+void Client::setReliable(const std::string& pathPattern)
+{
+	if (ofContains(reliablePatterns, pathPattern)) return;
+	reliablePatterns.push_back(pathPattern);
+}
+
+void Client::setRetransmission(uint64_t retransmitMillis, int maxAttempts)
+{
+	this->retransmitMillis = retransmitMillis;
+	maxDeliveryAttempts = std::max(maxAttempts, 1);
+}
+
+std::size_t Client::getUnacknowledgedCount() const
+{
+	return unacknowledgedRequests.size() + waitingRequests.size();
+}
+
+bool Client::isReliable(const std::string& path) const
+{
+	for (auto& pattern : reliablePatterns)
+	{
+		if (matchesPathPattern(pattern, path)) return true;
+	}
+	return false;
+}
+
+void Client::sendReliably(const std::string& method, const ofxOscMessage& message)
+{
+	if (method == MethodSetParam)
+	{
+		// The new value supersedes the one of the same parameter that hasn't been acknowledged yet:
+		auto path = message.getArgAsString(0);
+		auto superseded = [&](const ReliableRequest& request)
+		{
+			return request.method == MethodSetParam && request.message.getArgAsString(0) == path;
+		};
+		waitingRequests.erase(std::remove_if(waitingRequests.begin(), waitingRequests.end(), superseded),
+							  waitingRequests.end());
+		unacknowledgedRequests.erase(std::remove_if(unacknowledgedRequests.begin(),
+													unacknowledgedRequests.end(),
+													superseded),
+									 unacknowledgedRequests.end());
+	}
+	ReliableRequest request;
+	request.method = method;
+	request.message = message;
+	waitingRequests.push_back(std::move(request));
+	sendWaitingRequests();
+}
+
+void Client::sendWaitingRequests()
+{
+	while (!waitingRequests.empty() && unacknowledgedRequests.size() < ReliableWindow)
+	{
+		auto request = std::move(waitingRequests.front());
+		waitingRequests.pop_front();
+		request.requestId = static_cast<int32_t>(nextRequestId++ & 0x7fffffff);
+		request.message.setAddress(ApiReliable + "/" + request.method + "/" + ofToString(request.requestId));
+		request.lastSentMillis = ofGetElapsedTimeMillis();
+		request.attempts = 1;
+		oscSender.sendMessage(request.message);
+		unacknowledgedRequests.push_back(std::move(request));
+	}
+}
+
+void Client::retransmitRequests()
+{
+	// Retransmitting to a Server that is known to be gone would only use up the attempts:
+	if (unacknowledgedRequests.empty() || (keepConnected && !connected)) return;
+	auto now = ofGetElapsedTimeMillis();
+	std::vector<ofxOscMessage> failed;
+	for (auto request = unacknowledgedRequests.begin(); request != unacknowledgedRequests.end();)
+	{
+		if (now - request->lastSentMillis < retransmitMillis)
+		{
+			++request;
+		}
+		else if (request->attempts >= maxDeliveryAttempts)
+		{
+			ofLogError(LogModuleName) << "The Server did not acknowledge " << request->method << " after "
+									  << request->attempts << " attempts";
+			request->message.setAddress(ApiRoot + "/" + request->method);
+			failed.push_back(std::move(request->message));
+			request = unacknowledgedRequests.erase(request);
+		}
+		else
+		{
+			oscSender.sendMessage(request->message);
+			request->lastSentMillis = now;
+			request->attempts++;
+			++request;
+		}
+	}
+	sendWaitingRequests();
+	// Notified last, since the listeners may send new calls:
+	for (auto& message : failed)
+	{
+		deliveryFailedEvent.notify(message);
+	}
+}
+
+void Client::acknowledgeRequest(int32_t requestId)
+{
+	auto request = std::find_if(unacknowledgedRequests.begin(), unacknowledgedRequests.end(),
+								[requestId](const ReliableRequest& r) { return r.requestId == requestId; });
+	// Acks of retransmitted calls can arrive twice:
+	if (request == unacknowledgedRequests.end()) return;
+	unacknowledgedRequests.erase(request);
+	sendWaitingRequests();
+}
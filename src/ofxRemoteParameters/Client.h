@@ -6,9 +6,19 @@
 #define OFXREMOTEPARAMETERS_CLIENT_H
 
 #include <ofThread.h>
+#include <deque>
+#include <typeindex>
 #include <unordered_map>
 #include "ofxOsc.h"
 #include "ofxRemoteParameters.h"
+#include "ParameterTypes.h"
+#include "ModelParser.h"
+#include "UpdateFilter.h"
+#include "MulticastReceiver.h"
+#include "WaitableOscReceiver.h"
+#include "PacketSender.h"
+#include "Tracing.h"
+#include "ModelCompression.h"
 
 namespace ofxRemoteParameters
 {
@@ -28,8 +38,74 @@ namespace ofxRemoteParameters
 		 */
 		bool setup(ofParameterGroup& parameterGroup, std::string serverAddress, int serverInPort = DefaultServerInPort,
 				   int serverOutPort = DefaultServerOutPort);
+		/**
+		 * @brief Connects to the Server and downloads its model. From then on the Client checks the connection with
+		 * heartbeats and reconnects if it is lost. When it reconnects to a Server that still has the same model
+		 * (see Server::getModelIdentity()), the model is not downloaded again.
+		 */
 		void connect();
 
+		/**
+		 * @brief Sets up a receive-only Client that follows the model and the values that a Server publishes to a
+		 * multicast group with Server::startMulticast(). The observer never sends anything to the Server, so local
+		 * changes to its parameters are not sent, and connect() must not be called.
+		 * @param parameterGroup The ofParameterGroup that the observer will manage.
+		 * @param groupAddress The multicast group of the Server, e.g. 239.255.0.1.
+		 * @param port The multicast port of the Server.
+		 * @return false if the group could not be joined.
+		 */
+		bool setupObserver(ofParameterGroup& parameterGroup, const std::string& groupAddress, int port);
+		bool isObserver() const;
+		/**
+		 * @brief Stops checking the connection and reconnecting. Call connect() to start again.
+		 */
+		void disconnect();
+		bool isConnected() const;
+
+		/**
+		 * @brief Configures how the Client detects that the Server is gone.
+		 * @param intervalMillis How often to send a heartbeat to the Server, or 0 to disable the heartbeat. Defaults
+		 * to DefaultHeartbeatIntervalMillis.
+		 * @param timeoutMillis How long the Server can stay silent before the connection is considered lost. Defaults
+		 * to DefaultHeartbeatTimeoutMillis. It should be a few times the interval, so that a single lost packet isn't
+		 * taken for a lost connection.
+		 */
+		void setHeartbeat(uint64_t intervalMillis, uint64_t timeoutMillis);
+
+		/**
+		 * @brief Whether to reconnect automatically when the connection is lost (the default), or when the Server
+		 * doesn't answer connect(). Attempts are spaced with an exponential backoff.
+		 * @param minBackoffMillis The time before the second attempt. The first one is made right away.
+		 * @param maxBackoffMillis The longest time between attempts.
+		 */
+		void setAutoReconnect(bool autoReconnect, uint64_t minBackoffMillis = 250, uint64_t maxBackoffMillis = 5000);
+
+		/**
+		 * @brief The Client needs to continuously receive messages and check its connection by calling update() or
+		 * poll(), and this method determines whether it does so automatically on the ofMainLoop::loopEvent (the
+		 * default). Disable it to use the Client without a running OF app, e.g. in a headless daemon.
+		 */
+		void setAutoUpdate(bool autoUpdate);
+		/**
+		 * @brief Applies the messages received from the Server, sends the values held back by the update filters and
+		 * checks the connection. If auto updates are enabled you do not need to call this method. The parameter
+		 * listeners are notified on the thread that calls it.
+		 */
+		void update();
+		/**
+		 * @brief Sleeps until a message arrives from the Server or timeoutMillis pass, then calls update(). Calling
+		 * it in a loop lets a headless Client idle at near zero CPU. The wait is cut short to keep the heartbeat
+		 * going while the Client is connected.
+		 * @return true if a message was received.
+		 */
+		bool poll(uint64_t timeoutMillis);
+
+		/**
+		 * @brief Whether to ask the Server for a compressed model. Enabled by default. Servers that don't support
+		 * compression send the model as text anyway.
+		 */
+		void setModelCompression(bool enabled);
+
 		/**
 		 * @brief Adds support for new ofParameter types. The type must also be supported by the Server
 		 * @tparam T The "inner" type for the ofParameter. i.e. for an ofParameter&lt;int&gt; you would make `T` be `int`
@@ -38,32 +114,118 @@ namespace ofxRemoteParameters
 		template<class T>
 		void addParameterType(std::string typeName)
 		{
-			auto f = [this](std::string name, std::string value, std::string min, std::string max, ofEventListeners& el)
+			auto f = [this](const std::string& name,
+							const std::string& path,
+							const std::string& value,
+							const std::string& min,
+							const std::string& max,
+							ofEventListeners& el)
 			{
-				auto pValue = ofFromString<T>(value);
-				auto param = ofParameter<T>(name, pValue);
-				if (!min.empty() && !max.empty())
-				{
-					auto pMin = ofFromString<T>(min);
-					auto pMax = ofFromString<T>(max);
-					param.setMin(pMin);
-					param.setMax(pMax);
-				}
-				auto paramPtr = param.newReference();
-				el.push(param.newListener([this, paramPtr](T& value) {
-					setRemoteParameter(paramPtr);
-				}));
-				return paramPtr;
+				return createParameter<T>(name, path, value, min, max, el);
 			};
 
 			typeConstructors[typeName] = f;
 		}
 
+		/**
+		 * @brief Registers every type in a TypeList in one call, with the name given by its TypeTraits.
+		 * Registering the same list with Server::addParameterTypes() guarantees that both sides use the same names.
+		 * @tparam List A TypeList, e.g. TypeList<MyType, MyOtherType>.
+		 */
+		template<typename List>
+		void addParameterTypes()
+		{
+			forEachType(List(), [this](auto tag)
+			{
+				using T = typename decltype(tag)::type;
+				auto id = builtinTypeId<T>();
+				if (id != CustomTypeId)
+				{
+					builtinTypeIds[TypeTraits<T>::name] = id;
+				}
+				else
+				{
+					addParameterType<T>(TypeTraits<T>::name);
+				}
+			});
+		}
+
+		/**
+		 * @brief Filters the values sent to the Server for the parameters whose path matches pathPattern, so that
+		 * only significant changes are sent (see UpdateFilterSet::setPathFilter()).
+		 */
+		void setUpdateFilter(const std::string& pathPattern, const UpdateFilter& filter);
+
+		/**
+		 * @brief Filters the values sent to the Server for every parameter of the given type. Filters set for a path
+		 * pattern take precedence.
+		 */
+		template<class T>
+		void setUpdateFilter(const UpdateFilter& filter)
+		{
+			typeUpdateFilters[std::type_index(typeid(ofParameter<T>))] = filter;
+		}
+
+		/**
+		 * @brief Overwrites count elements of an array parameter starting at offset, growing the array if needed.
+		 * offset can be at most the size of the array.
+		 * Only the elements that changed are sent to the Server. Changing an array parameter in any other way, e.g.
+		 * through a GUI, sends the range that changed too.
+		 * @tparam Element int, float, glm::vec2, glm::vec3 or glm::vec4.
+		 */
+		template<typename Element>
+		void setRange(const std::string& path, std::size_t offset, const std::vector<Element>& values)
+		{
+			auto parameter = std::dynamic_pointer_cast<ofParameter<std::vector<Element>>>(findParameter(path));
+			if (!parameter)
+			{
+				ofLogError(LogModuleName) << "setRange: there is no array parameter of that type at " << path;
+				return;
+			}
+			if (!writeRange(*parameter, offset, values.data(), values.size()))
+			{
+				ofLogError(LogModuleName) << "setRange: offset " << offset << " is past the end of " << path;
+			}
+		}
+
 		/**
 		 * @brief Calls a Server Method of the given name.
 		 * @param methodName The name of the method.
 		 */
 		void callServerMethod(const std::string& methodName);
+		/**
+		 * @brief Calls a Server Method with acknowledged delivery: the call is retransmitted until the Server
+		 * acknowledges it, and the Server executes it only once. Use it for calls that must arrive, like a blackout
+		 * or saving the project. deliveryFailedEvent is notified if the Server never acknowledges it.
+		 */
+		void callServerMethodReliably(const std::string& methodName);
+		/**
+		 * @brief Sends the values of the parameters whose path matches pathPattern with acknowledged delivery, like
+		 * callServerMethodReliably(). `*` matches any sequence of characters, e.g. "/My_Group/Cues*". A new value
+		 * replaces the one of the same parameter that is still waiting for its ack, and array parameters are sent
+		 * whole rather than by ranges, so that a retransmission never overwrites a newer value.
+		 */
+		void setReliable(const std::string& pathPattern);
+		/**
+		 * @brief Configures acknowledged delivery.
+		 * @param retransmitMillis How long to wait for an ack before sending a call again. Defaults to
+		 * DefaultRetransmitMillis.
+		 * @param maxAttempts How many times a call is sent before giving up. Defaults to DefaultMaxDeliveryAttempts.
+		 */
+		void setRetransmission(uint64_t retransmitMillis, int maxAttempts);
+		/**
+		 * @return The number of acknowledged calls that have not been acknowledged yet, including the ones waiting
+		 * for room in the retransmit window.
+		 */
+		std::size_t getUnacknowledgedCount() const;
+
+		/**
+		 * @brief Asks the Server for the current values of the parameters under subtreePath, without the names, types,
+		 * limits and methods that getModel resends. Much cheaper than downloading the model to poll values, e.g. for
+		 * a dashboard. valuesReceivedEvent is notified when they are applied.
+		 * @param subtreePath The path of a group or a parameter, e.g. "/My_Group/Lights". Empty for all of them.
+		 */
+		void requestValues(const std::string& subtreePath = "");
 
 		/**
 		 * @brief Use this constant to exclusively set the ofLogLevel of the Client.
@@ -75,28 +237,235 @@ namespace ofxRemoteParameters
 		 * @brief Notifies when the model is received from the Server
 		 */
 		ofEvent<void> modelLoadedEvent;
+		/**
+		 * @brief Notifies every time the Server answers connect(), including automatic reconnections.
+		 */
+		ofEvent<void> connectedEvent;
+		/**
+		 * @brief Notifies when the Server has not answered for longer than the heartbeat timeout.
+		 */
+		ofEvent<void> connectionLostEvent;
+		/**
+		 * @brief Notifies when the values requested with requestValues() have been applied.
+		 */
+		ofEvent<void> valuesReceivedEvent;
+		/**
+		 * @brief Notifies when an acknowledged call was sent the maximum number of times without being acknowledged.
+		 * The message is the plain call, e.g. /ofxrpMethod/set with the path and the value.
+		 */
+		ofEvent<ofxOscMessage> deliveryFailedEvent;
 
 	private:
 		void downloadModel();
+		/**
+		 * @brief Whether a getModel request was sent and its reply can still arrive. Requests that went unanswered
+		 * for a few heartbeat intervals are given up, so that the model is requested again.
+		 */
+		bool isModelRequestPending() const;
+		void sendConnect();
+		void updateConnection();
+		void receiveMessages();
+		/// Listens to the ofMainLoop::loopEvent if auto updates are enabled and the Client is set up
+		void updateLoopListener();
+		bool isReliable(const std::string& path) const;
+		/**
+		 * @brief Queues a copy of message, a call to method, for acknowledged delivery.
+		 */
+		void sendReliably(const std::string& method, const ofxOscMessage& message);
+		void sendWaitingRequests();
+		void retransmitRequests();
+		void acknowledgeRequest(int32_t requestId);
+		std::shared_ptr<ofAbstractParameter> findParameter(const std::string& path);
+		void applyServerValue(const std::string& path, const std::string& value);
+		void applyServerValue(const std::shared_ptr<ofAbstractParameter>& parameter,
+							  const std::string& path,
+							  const std::string& value);
+		/**
+		 * @brief Applies a getValues response: the model identity, the subtree path and the values in model order.
+		 */
+		void applyServerValues(ofxOscMessage& message);
+		/**
+		 * @brief Gets the model from a getModel response, decompressing it if needed.
+		 * @return false if the model could not be decompressed.
+		 */
+		bool getModelText(const ofxOscMessage& message, std::string& model);
+		void applyServerRange(const std::string& path, int32_t offset, const ofBuffer& values);
+		const UpdateFilter* findUpdateFilter(const std::string& path, const ofAbstractParameter& parameter) const;
 
-		ofxOscReceiver oscReceiver;
-		ofxOscSender oscSender;
+		WaitableOscReceiver oscReceiver;
+		PacketSender oscSender;
 		ofEventListener loopListener;
+		bool autoUpdate = true;
+		bool isSetUp = false;
 		ofEventListeners paramListeners;
 		std::shared_ptr<ofParameterGroup> parameterGroup;
-		bool isConnected = false;
+		bool connected = false;
+		/// Set by connect() and cleared by disconnect(): whether the Client should try to stay connected
+		bool keepConnected = false;
+		/// Servers that predate the heartbeat don't send their model identity, and the Client can't check them
+		bool serverHasHeartbeat = false;
+		bool modelRequested = false;
+		uint64_t modelRequestMillis = 0;
+		bool hasModel = false;
+		std::string modelIdentity;
+		/// The key of the model, sent along with the ids of the parameters
+		int32_t modelKey = 0;
+		uint64_t heartbeatIntervalMillis = DefaultHeartbeatIntervalMillis;
+		uint64_t heartbeatTimeoutMillis = DefaultHeartbeatTimeoutMillis;
+		bool autoReconnect = true;
+		bool modelCompression = true;
+		uint64_t minBackoffMillis = 250;
+		uint64_t maxBackoffMillis = 5000;
+		uint64_t backoffMillis = 0;
+		uint64_t lastResponseMillis = 0;
+		uint64_t lastHeartbeatMillis = 0;
+		uint64_t nextConnectMillis = 0;
+		UpdateFilterSet updateFilters;
+
+		struct ReliableRequest
+		{
+			std::string method;
+			/// The plain call until it is sent, then addressed to ApiReliable
+			ofxOscMessage message;
+			int32_t requestId = 0;
+			uint64_t lastSentMillis = 0;
+			int attempts = 0;
+		};
+		/// How many acknowledged calls can wait for their ack at the same time. The others wait for room.
+		static const std::size_t ReliableWindow = 32;
+		/// The calls waiting for their ack, oldest first
+		std::deque<ReliableRequest> unacknowledgedRequests;
+		std::deque<ReliableRequest> waitingRequests;
+		std::vector<std::string> reliablePatterns;
+		uint32_t nextRequestId;
+		uint64_t retransmitMillis = DefaultRetransmitMillis;
+		int maxDeliveryAttempts = DefaultMaxDeliveryAttempts;
+		/// The array values that the Server has, to send only the ranges that changed
+		ArrayShadows<std::string> arrayShadows;
+		std::unordered_map<std::type_index, UpdateFilter> typeUpdateFilters;
+		struct IndexedValue
+		{
+			/// nullptr for the parameters of unknown types, which are not created but still take a slot
+			std::shared_ptr<ofAbstractParameter> parameter;
+			std::string path;
+			/// The id of the parameter in the model, or -1 if the Server doesn't give ids
+			int32_t id = -1;
+		};
+		/// The parameters in model order, to match the values of a getValues response to them
+		std::vector<IndexedValue> valueIndex;
+		/// The [begin, end) range of valueIndex for the path of every group and parameter
+		std::unordered_map<std::string, std::pair<std::size_t, std::size_t>> valueIndexRanges;
+		/// Set while a value pushed by the Server is applied, so that it is not sent back
+		bool applyingServerValue = false;
+		bool observer = false;
+		MulticastReceiver multicastReceiver;
 		std::unordered_map<std::string, std::function<std::shared_ptr<ofAbstractParameter>(
-				std::string name,
-				std::string value,
-				std::string min,
-				std::string max,
+				const std::string& name,
+				const std::string& path,
+				const std::string& value,
+				const std::string& min,
+				const std::string& max,
 				ofEventListeners& el)>> typeConstructors;
+		/// The built-in types are constructed through a switch on their TypeId rather than through typeConstructors
+		std::unordered_map<std::string, TypeId> builtinTypeIds;
+
+		/// Encodes the values sent, so that sending doesn't allocate
+		OscPacketWriter packetWriter;
+
+		/**
+		 * @param path The path of the parameter in the model. Its listener keeps it, so that local changes don't have
+		 * to walk the group hierarchy to find where to send the value.
+		 */
+		template<class T>
+		std::shared_ptr<ofAbstractParameter> createParameter(const std::string& name,
+															 const std::string& path,
+															 const std::string& value,
+															 const std::string& min,
+															 const std::string& max,
+															 ofEventListeners& el)
+		{
+			auto pValue = valueFromString<T>(value);
+			auto param = ofParameter<T>(name, pValue);
+			if (!min.empty() && !max.empty())
+			{
+				auto pMin = valueFromString<T>(min);
+				auto pMax = valueFromString<T>(max);
+				param.setMin(pMin);
+				param.setMax(pMax);
+			}
+			auto paramPtr = param.newReference();
+			el.push(param.newListener([this, paramPtr, path](T& value) {
+				if (applyingServerValue) return;
+				setRemoteParameter(*paramPtr, path, value);
+			}));
+			return paramPtr;
+		}
+
+		class ModelBuilder;
+		ModelParser modelParser;
 
 	protected:
 		void parseReceivedMessage(ofxOscMessage& message);
 		void parseModel(const std::string& basicString);
-		void parseGroup(ofParameterGroup& paramGroup, ofXml& groupXml);
+		/**
+		 * @brief Creates the parameter described by a model element and adds it to paramGroup.
+		 * @param path The path of the parameter in the model.
+		 * @return The parameter, or nullptr if its type is unknown.
+		 */
+		std::shared_ptr<ofAbstractParameter> addParameter(ofParameterGroup& paramGroup,
+														  const ModelParameter& modelParameter,
+														  const std::string& path);
+		/**
+		 * @brief Sends the value of p to the Server, bypassing the update filters.
+		 */
 		void setRemoteParameter(std::shared_ptr<ofAbstractParameter> p);
+
+		/**
+		 * @brief Sends value, the new value of p, to the Server if its update filter finds the change significant.
+		 */
+		template<class T>
+		void setRemoteParameter(std::shared_ptr<ofAbstractParameter> p, const T& value)
+		{
+			setRemoteParameter(*p, getParameterPath(*p), value);
+		}
+
+		/**
+		 * @brief Like setRemoteParameter(p, value), for a parameter whose path is already known.
+		 */
+		template<class T>
+		void setRemoteParameter(const ofAbstractParameter& p, const std::string& path, const T& value)
+		{
+			if (observer) return;
+			if constexpr (ArrayTraits<T>::isArray)
+			{
+				std::size_t offset;
+				std::size_t count;
+				if (!arrayShadows.diff(path, value, offset, count) || (count > 0 && isReliable(path)))
+				{
+					sendParameterValue(path, arrayToString(value));
+				}
+				else if (count > 0)
+				{
+					sendParameterRange(path, offset, arrayToBlob(value.data() + offset, count));
+				}
+				return;
+			}
+			auto filter = findUpdateFilter(path, p);
+			if (!filter)
+			{
+				sendParameterValue(path, valueToString(value));
+				return;
+			}
+			std::string serialized;
+			if (updateFilters.filterValue(path, *filter, value, serialized, ofGetElapsedTimeMicros()))
+			{
+				sendParameterValue(path, serialized);
+			}
+		}
+
+		std::string getParameterPath(const ofAbstractParameter& p) const;
+		void sendParameterValue(const std::string& path, const std::string& value);
+		void sendParameterRange(const std::string& path, std::size_t offset, const ofBuffer& values);
 	};
 
 }
@@ -0,0 +1,109 @@
+//
+// Typed arguments for server methods, decoded straight from the OSC argument types.
+//
+
+#include "MethodArguments.h"
+#include <array>
+#include <cerrno>
+#include <cstdlib>
+
+using namespace ofxRemoteParameters;
+
+namespace
+{
+	const std::array<std::string, 6> TypeNames = {"int", "float", "double", "bool", "string", "blob"};
+}
+
+const std::string& ofxRemoteParameters::argumentTypeName(ArgumentType type)
+{
+	return TypeNames[static_cast<std::size_t>(type)];
+}
+
+bool ofxRemoteParameters::argumentTypeFromName(const std::string& typeName, ArgumentType& type)
+{
+	for (std::size_t i = 0; i < TypeNames.size(); i++)
+	{
+		if (TypeNames[i] == typeName)
+		{
+			type = static_cast<ArgumentType>(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ofxRemoteParameters::argumentFromString(ArgumentType type, const std::string& text, ArgumentValue& value)
+{
+	char* end = nullptr;
+	errno = 0;
+	switch (type)
+	{
+		case ArgumentType::Int:
+			value = static_cast<int32_t>(std::strtol(text.c_str(), &end, 10));
+			break;
+		case ArgumentType::Float:
+			value = std::strtof(text.c_str(), &end);
+			break;
+		case ArgumentType::Double:
+			value = std::strtod(text.c_str(), &end);
+			break;
+		case ArgumentType::Bool:
+			if (text == "1" || text == "true") value = true;
+			else if (text == "0" || text == "false") value = false;
+			else return false;
+			return true;
+		case ArgumentType::String:
+			value = text;
+			return true;
+		case ArgumentType::Blob:
+			value = ofBuffer();
+			return true;
+	}
+	return !text.empty() && *end == '\0' && errno == 0;
+}
+
+bool ofxRemoteParameters::argumentFromOsc(const ofxOscMessage& message,
+										  std::size_t index,
+										  ArgumentType type,
+										  ArgumentValue& value)
+{
+	auto oscType = message.getArgType(index);
+	switch (type)
+	{
+		case ArgumentType::Int:
+			if (oscType == OFXOSC_TYPE_INT32) value = message.getArgAsInt32(index);
+			else if (oscType == OFXOSC_TYPE_INT64) value = static_cast<int32_t>(message.getArgAsInt64(index));
+			else return false;
+			return true;
+		case ArgumentType::Float:
+			if (oscType == OFXOSC_TYPE_FLOAT) value = message.getArgAsFloat(index);
+			else if (oscType == OFXOSC_TYPE_DOUBLE) value = static_cast<float>(message.getArgAsDouble(index));
+			else if (oscType == OFXOSC_TYPE_INT32) value = static_cast<float>(message.getArgAsInt32(index));
+			else if (oscType == OFXOSC_TYPE_INT64) value = static_cast<float>(message.getArgAsInt64(index));
+			else return false;
+			return true;
+		case ArgumentType::Double:
+			if (oscType == OFXOSC_TYPE_DOUBLE) value = message.getArgAsDouble(index);
+			else if (oscType == OFXOSC_TYPE_FLOAT) value = static_cast<double>(message.getArgAsFloat(index));
+			else if (oscType == OFXOSC_TYPE_INT32) value = static_cast<double>(message.getArgAsInt32(index));
+			else if (oscType == OFXOSC_TYPE_INT64) value = static_cast<double>(message.getArgAsInt64(index));
+			else return false;
+			return true;
+		case ArgumentType::Bool:
+			if (oscType == OFXOSC_TYPE_TRUE) value = true;
+			else if (oscType == OFXOSC_TYPE_FALSE) value = false;
+			else if (oscType == OFXOSC_TYPE_INT32) value = message.getArgAsInt32(index) != 0;
+			else return false;
+			return true;
+		case ArgumentType::String:
+			if (oscType == OFXOSC_TYPE_STRING) value = message.getArgAsString(index);
+			else if (oscType == OFXOSC_TYPE_SYMBOL) value = message.getArgAsSymbol(index);
+			else return false;
+			return true;
+		case ArgumentType::Blob:
+			if (oscType != OFXOSC_TYPE_BLOB) return false;
+			value = message.getArgAsBlob(index);
+			return true;
+	}
+	return false;
+}
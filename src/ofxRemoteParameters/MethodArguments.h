@@ -0,0 +1,84 @@
+//
+// Typed arguments for server methods, decoded straight from the OSC argument types.
+//
+
+#ifndef OFXREMOTEPARAMETERS_METHODARGUMENTS_H
+#define OFXREMOTEPARAMETERS_METHODARGUMENTS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+#include "ofFileUtils.h"
+#include "ofxOsc.h"
+
+namespace ofxRemoteParameters
+{
+	/**
+	 * @brief The types that a server method argument can have. The order matches the alternatives of ArgumentValue.
+	 */
+	enum class ArgumentType : uint8_t
+	{
+		Int,
+		Float,
+		Double,
+		Bool,
+		String,
+		Blob
+	};
+
+	using ArgumentValue = std::variant<int32_t, float, double, bool, std::string, ofBuffer>;
+
+	/**
+	 * @brief The name of an argument type in ServerMethod::Argument::type and in the model: "int", "float", "double",
+	 * "bool", "string" or "blob".
+	 */
+	const std::string& argumentTypeName(ArgumentType type);
+
+	/**
+	 * @return false if typeName is not the name of an argument type.
+	 */
+	bool argumentTypeFromName(const std::string& typeName, ArgumentType& type);
+
+	/**
+	 * @brief Parses the text form of an argument, e.g. a default value. Blobs can't be parsed, and are empty.
+	 * @return false if text is not a value of the type.
+	 */
+	bool argumentFromString(ArgumentType type, const std::string& text, ArgumentValue& value);
+
+	/**
+	 * @brief Decodes argument index of message as type, converting between the numeric OSC types but never from
+	 * or to strings.
+	 * @return false if the OSC argument can't be converted to type.
+	 */
+	bool argumentFromOsc(const ofxOscMessage& message, std::size_t index, ArgumentType type, ArgumentValue& value);
+
+	/**
+	 * @brief The decoded arguments of a call to a server method, in the order of its schema. Missing optional
+	 * arguments have their default value.
+	 */
+	class MethodArguments
+	{
+	public:
+		/**
+		 * @tparam T int32_t, float, double, bool, std::string or ofBuffer, according to the type of the argument in
+		 * the schema. Throws std::bad_variant_access for any other type.
+		 */
+		template<typename T>
+		const T& get(std::size_t index) const
+		{
+			return std::get<T>(values[index]);
+		}
+
+		std::size_t size() const { return values.size(); }
+
+		const ArgumentValue& operator[](std::size_t index) const { return values[index]; }
+
+	private:
+		friend class Server;
+		std::vector<ArgumentValue> values;
+	};
+}
+
+#endif //OFXREMOTEPARAMETERS_METHODARGUMENTS_H
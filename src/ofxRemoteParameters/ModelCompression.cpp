@@ -0,0 +1,51 @@
+//
+// zlib compression of the model for getModel replies.
+//
+
+#include "ModelCompression.h"
+#include <sstream>
+#include "Poco/DeflatingStream.h"
+#include "Poco/InflatingStream.h"
+#include "Poco/Exception.h"
+
+using namespace ofxRemoteParameters;
+
+bool ModelCompression::compress(const std::string& model, ofBuffer& compressed)
+{
+	try
+	{
+		std::ostringstream output;
+		Poco::DeflatingOutputStream deflater(output, Poco::DeflatingStreamBuf::STREAM_ZLIB);
+		deflater.write(model.data(), static_cast<std::streamsize>(model.size()));
+		deflater.close();
+		auto data = output.str();
+		compressed.set(data.data(), data.size());
+		return true;
+	}
+	catch (const Poco::Exception&)
+	{
+		return false;
+	}
+}
+
+bool ModelCompression::decompress(const ofBuffer& compressed, std::string& model)
+{
+	try
+	{
+		std::istringstream input(std::string(compressed.getData(), compressed.size()));
+		Poco::InflatingInputStream inflater(input, Poco::InflatingStreamBuf::STREAM_ZLIB);
+		model.clear();
+		char buffer[16384];
+		while (inflater)
+		{
+			inflater.read(buffer, sizeof(buffer));
+			model.append(buffer, static_cast<std::size_t>(inflater.gcount()));
+			if (model.size() > MaxModelBytes) return false;
+		}
+		return inflater.eof() && !inflater.bad();
+	}
+	catch (const Poco::Exception&)
+	{
+		return false;
+	}
+}
@@ -0,0 +1,32 @@
+//
+// zlib compression of the model for getModel replies.
+//
+
+#ifndef OFXREMOTEPARAMETERS_MODELCOMPRESSION_H
+#define OFXREMOTEPARAMETERS_MODELCOMPRESSION_H
+
+#include <cstddef>
+#include <string>
+#include "ofFileUtils.h"
+
+namespace ofxRemoteParameters
+{
+	namespace ModelCompression
+	{
+		/// Models are not inflated past this size, so that a corrupt or hostile reply can't exhaust the memory.
+		const std::size_t MaxModelBytes = 64 * 1024 * 1024;
+
+		/**
+		 * @brief Compresses the model with zlib (RFC 1950), through the Poco streams that OF already links.
+		 * @return false if compression failed.
+		 */
+		bool compress(const std::string& model, ofBuffer& compressed);
+
+		/**
+		 * @return false if the data is not a valid zlib stream or inflates past MaxModelBytes.
+		 */
+		bool decompress(const ofBuffer& compressed, std::string& model);
+	}
+}
+
+#endif //OFXREMOTEPARAMETERS_MODELCOMPRESSION_H
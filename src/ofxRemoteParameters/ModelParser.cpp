@@ -0,0 +1,308 @@
+//
+// Single-pass parser for the XML model sent by the Server.
+//
+
+#include "ModelParser.h"
+#include <cstring>
+#include <cstdlib>
+
+using namespace ofxRemoteParameters;
+
+namespace
+{
+	inline bool isSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+	}
+
+	inline bool isNameEnd(char c)
+	{
+		return isSpace(c) || c == '>' || c == '/' || c == '=';
+	}
+
+	void appendUtf8(unsigned long codePoint, std::string& target)
+	{
+		if (codePoint < 0x80)
+		{
+			target += static_cast<char>(codePoint);
+		}
+		else if (codePoint < 0x800)
+		{
+			target += static_cast<char>(0xC0 | (codePoint >> 6));
+			target += static_cast<char>(0x80 | (codePoint & 0x3F));
+		}
+		else if (codePoint < 0x10000)
+		{
+			target += static_cast<char>(0xE0 | (codePoint >> 12));
+			target += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+			target += static_cast<char>(0x80 | (codePoint & 0x3F));
+		}
+		else
+		{
+			target += static_cast<char>(0xF0 | (codePoint >> 18));
+			target += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+			target += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+			target += static_cast<char>(0x80 | (codePoint & 0x3F));
+		}
+	}
+}
+
+bool ModelParser::parse(const std::string& xml, ModelHandler& handler)
+{
+	position = xml.data();
+	end = xml.data() + xml.size();
+	this->handler = &handler;
+	contexts.clear();
+	field = nullptr;
+
+	while (position < end)
+	{
+		if (*position != '<')
+		{
+			auto textBegin = position;
+			auto next = static_cast<const char*>(std::memchr(position, '<', end - position));
+			position = next ? next : end;
+			if (field) appendText(textBegin, position, *field);
+			continue;
+		}
+
+		auto remaining = static_cast<std::size_t>(end - position);
+		if (remaining >= 2 && position[1] == '?')
+		{
+			if (!skipPast("?>")) return false;
+		}
+		else if (remaining >= 4 && std::strncmp(position, "<!--", 4) == 0)
+		{
+			if (!skipPast("-->")) return false;
+		}
+		else if (remaining >= 9 && std::strncmp(position, "<![CDATA[", 9) == 0)
+		{
+			auto cdataBegin = position + 9;
+			if (!skipPast("]]>")) return false;
+			if (field) field->append(cdataBegin, position - 3);
+		}
+		else if (remaining >= 2 && position[1] == '!')
+		{
+			if (!skipPast(">")) return false;
+		}
+		else if (remaining >= 2 && position[1] == '/')
+		{
+			if (!parseEndTag()) return false;
+		}
+		else
+		{
+			bool isEmptyElement;
+			if (!parseStartTag(isEmptyElement)) return false;
+			startElement();
+			if (isEmptyElement) endElement();
+		}
+	}
+
+	return contexts.empty();
+}
+
+bool ModelParser::skipPast(const char* terminator)
+{
+	auto length = std::strlen(terminator);
+	for (auto p = position; p + length <= end; p++)
+	{
+		if (std::strncmp(p, terminator, length) == 0)
+		{
+			position = p + length;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ModelParser::parseStartTag(bool& isEmptyElement)
+{
+	position++; // <
+	auto nameBegin = position;
+	while (position < end && !isNameEnd(*position)) position++;
+	if (position == end || position == nameBegin) return false;
+	elementName.assign(nameBegin, position);
+
+	attributeCount = 0;
+	while (true)
+	{
+		while (position < end && isSpace(*position)) position++;
+		if (position == end) return false;
+
+		if (*position == '>')
+		{
+			position++;
+			isEmptyElement = false;
+			return true;
+		}
+		if (*position == '/')
+		{
+			if (end - position < 2 || position[1] != '>') return false;
+			position += 2;
+			isEmptyElement = true;
+			return true;
+		}
+
+		auto attributeNameBegin = position;
+		while (position < end && !isNameEnd(*position)) position++;
+		auto attributeNameEnd = position;
+		while (position < end && isSpace(*position)) position++;
+		if (position == end || *position != '=') return false;
+		position++;
+		while (position < end && isSpace(*position)) position++;
+		if (position == end || (*position != '"' && *position != '\'')) return false;
+
+		auto quote = *position++;
+		auto valueBegin = position;
+		auto valueEnd = static_cast<const char*>(std::memchr(position, quote, end - position));
+		if (!valueEnd) return false;
+		position = valueEnd + 1;
+
+		if (attributes.size() == attributeCount) attributes.emplace_back();
+		auto& attribute = attributes[attributeCount++];
+		attribute.first.assign(attributeNameBegin, attributeNameEnd);
+		attribute.second.clear();
+		appendText(valueBegin, valueEnd, attribute.second);
+	}
+}
+
+bool ModelParser::parseEndTag()
+{
+	if (!skipPast(">")) return false;
+	if (contexts.empty()) return false;
+	endElement();
+	return true;
+}
+
+void ModelParser::startElement()
+{
+	auto parent = contexts.empty() ? Context::Root : contexts.back();
+	auto context = Context::Ignored;
+
+	auto findAttribute = [this](const char* attributeName) -> const std::string*
+	{
+		for (std::size_t i = 0; i < attributeCount; i++)
+		{
+			if (attributes[i].first == attributeName) return &attributes[i].second;
+		}
+		return nullptr;
+	};
+
+	if (contexts.empty())
+	{
+		if (elementName == "ofxRemoteParameters") context = Context::Root;
+	}
+	else if (parent == Context::Root)
+	{
+		if (elementName == "Parameters")
+		{
+			context = Context::Parameters;
+			handler->parametersBegin();
+		}
+		else if (elementName == "Methods")
+		{
+			context = Context::Methods;
+		}
+	}
+	else if (parent == Context::Parameters || parent == Context::Group)
+	{
+		auto type = findAttribute("type");
+		auto name = findAttribute("name");
+		current.escapedName = elementName;
+		current.type = type ? *type : "";
+		current.name = name ? *name : "";
+		current.value.clear();
+		current.min.clear();
+		current.max.clear();
+		current.attributes.resize(attributeCount);
+		for (std::size_t i = 0; i < attributeCount; i++)
+		{
+			current.attributes[i].first = attributes[i].first;
+			current.attributes[i].second = attributes[i].second;
+		}
+
+		if (current.type == "group")
+		{
+			context = Context::Group;
+			handler->groupBegin(current);
+		}
+		else
+		{
+			context = Context::Parameter;
+		}
+	}
+	else if (parent == Context::Parameter)
+	{
+		if (elementName == "value") field = &current.value;
+		else if (elementName == "min") field = &current.min;
+		else if (elementName == "max") field = &current.max;
+		if (field) context = Context::Field;
+	}
+	else if (parent == Context::Methods)
+	{
+		auto uiName = findAttribute("uiName");
+		handler->method(elementName, uiName ? *uiName : elementName);
+	}
+
+	contexts.push_back(context);
+}
+
+void ModelParser::endElement()
+{
+	auto context = contexts.back();
+	contexts.pop_back();
+	switch (context)
+	{
+		case Context::Group:
+			handler->groupEnd();
+			break;
+		case Context::Parameter:
+			handler->parameter(current);
+			break;
+		case Context::Field:
+			field = nullptr;
+			break;
+		default:
+			break;
+	}
+}
+
+void ModelParser::appendText(const char* textBegin, const char* textEnd, std::string& target)
+{
+	while (textBegin < textEnd)
+	{
+		auto ampersand = static_cast<const char*>(std::memchr(textBegin, '&', textEnd - textBegin));
+		if (!ampersand)
+		{
+			target.append(textBegin, textEnd);
+			return;
+		}
+		target.append(textBegin, ampersand);
+
+		auto semicolon = static_cast<const char*>(std::memchr(ampersand, ';', textEnd - ampersand));
+		if (!semicolon)
+		{
+			target.append(ampersand, textEnd);
+			return;
+		}
+
+		auto entity = ampersand + 1;
+		auto length = semicolon - entity;
+		if (length == 3 && std::strncmp(entity, "amp", 3) == 0) target += '&';
+		else if (length == 2 && std::strncmp(entity, "lt", 2) == 0) target += '<';
+		else if (length == 2 && std::strncmp(entity, "gt", 2) == 0) target += '>';
+		else if (length == 4 && std::strncmp(entity, "quot", 4) == 0) target += '"';
+		else if (length == 4 && std::strncmp(entity, "apos", 4) == 0) target += '\'';
+		else if (length > 1 && entity[0] == '#')
+		{
+			bool isHex = entity[1] == 'x' || entity[1] == 'X';
+			appendUtf8(std::strtoul(entity + (isHex ? 2 : 1), nullptr, isHex ? 16 : 10), target);
+		}
+		else
+		{
+			// Unknown entity, keep it as it is
+			target.append(ampersand, semicolon + 1);
+		}
+		textBegin = semicolon + 1;
+	}
+}
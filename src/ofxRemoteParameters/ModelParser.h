@@ -0,0 +1,105 @@
+//
+// Single-pass parser for the XML model sent by the Server.
+//
+
+#ifndef OFXREMOTEPARAMETERS_MODELPARSER_H
+#define OFXREMOTEPARAMETERS_MODELPARSER_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ofxRemoteParameters
+{
+	/**
+	 * @brief A parameter element of the model, as reported by ModelParser. The strings are reused from one
+	 * parameter to the next, so copy anything that needs to outlive the callback.
+	 */
+	struct ModelParameter
+	{
+		std::string escapedName;
+		std::string type;
+		std::string name;
+		std::string value;
+		std::string min;
+		std::string max;
+		/// All the attributes of the parameter element, including type and name.
+		std::vector<std::pair<std::string, std::string>> attributes;
+
+		/**
+		 * @return The value of the attribute, or nullptr if the element doesn't have it.
+		 */
+		const std::string* getAttribute(const std::string& attributeName) const
+		{
+			for (auto& attribute : attributes)
+			{
+				if (attribute.first == attributeName) return &attribute.second;
+			}
+			return nullptr;
+		}
+	};
+
+	/**
+	 * @brief Receives the contents of the model from ModelParser, in document order.
+	 */
+	class ModelHandler
+	{
+	public:
+		virtual ~ModelHandler() = default;
+		/**
+		 * @brief Called when the Parameters section starts.
+		 */
+		virtual void parametersBegin() {}
+		virtual void groupBegin(const ModelParameter& group) {}
+		virtual void groupEnd() {}
+		virtual void parameter(const ModelParameter& parameter) {}
+		virtual void method(const std::string& identifier, const std::string& uiName) {}
+	};
+
+	/**
+	 * @brief Parses the model in a single pass, reporting groups, parameters and methods to a ModelHandler as
+	 * they are read. Unlike ofXml, it doesn't build a DOM, so memory use doesn't grow with the size of the model.
+	 */
+	class ModelParser
+	{
+	public:
+		/**
+		 * @return false if the model is not well-formed XML. Everything read up to the error has already been
+		 * reported to the handler.
+		 */
+		bool parse(const std::string& xml, ModelHandler& handler);
+
+	private:
+		enum class Context
+		{
+			Root,
+			Parameters,
+			Methods,
+			Group,
+			Parameter,
+			Field,
+			Ignored
+		};
+
+		bool parseStartTag(bool& isEmptyElement);
+		bool parseEndTag();
+		void startElement();
+		void endElement();
+		void appendText(const char* textBegin, const char* textEnd, std::string& target);
+		bool skipPast(const char* terminator);
+
+		const char* position = nullptr;
+		const char* end = nullptr;
+		ModelHandler* handler = nullptr;
+		std::vector<Context> contexts;
+		std::string* field = nullptr;
+
+		// Reused between elements to avoid allocations:
+		std::string elementName;
+		std::vector<std::pair<std::string, std::string>> attributes;
+		std::size_t attributeCount = 0;
+		ModelParameter current;
+	};
+}
+
+#endif //OFXREMOTEPARAMETERS_MODELPARSER_H
@@ -0,0 +1,75 @@
+//
+// Multiple-producer, single-consumer queue.
+//
+
+#ifndef OFXREMOTEPARAMETERS_MPSCQUEUE_H
+#define OFXREMOTEPARAMETERS_MPSCQUEUE_H
+
+#include <atomic>
+#include <utility>
+
+namespace ofxRemoteParameters
+{
+	/**
+	 * @brief An unbounded multiple-producer, single-consumer queue (after Dmitry Vyukov's non-intrusive MPSC design).
+	 * push() may be called from any number of threads and never waits on other producers or on the consumer: it is a
+	 * single atomic exchange plus a store. It does allocate a node with new, though, so it is only as lock-free as the
+	 * allocator, and should not be called where heap allocations are forbidden. tryPop() frees the node, and must
+	 * only be called from one thread at a time.
+	 * @note A push that is in progress while tryPop() runs may not be visible until the next tryPop().
+	 * @tparam T The element type. It must be default-constructible and movable.
+	 */
+	template<typename T>
+	class MpscQueue
+	{
+	public:
+		MpscQueue()
+		{
+			auto stub = new Node();
+			head.store(stub, std::memory_order_relaxed);
+			tail = stub;
+		}
+
+		~MpscQueue()
+		{
+			T discarded;
+			while (tryPop(discarded)) {}
+			delete tail;
+		}
+
+		MpscQueue(const MpscQueue&) = delete;
+		MpscQueue& operator=(const MpscQueue&) = delete;
+
+		void push(T&& value)
+		{
+			auto node = new Node();
+			node->value = std::move(value);
+			// Publish the node as the new head, then link the previous head to it:
+			auto previous = head.exchange(node, std::memory_order_acq_rel);
+			previous->next.store(node, std::memory_order_release);
+		}
+
+		bool tryPop(T& value)
+		{
+			auto next = tail->next.load(std::memory_order_acquire);
+			if (next == nullptr) return false;
+			value = std::move(next->value);
+			// next becomes the new stub node
+			delete tail;
+			tail = next;
+			return true;
+		}
+
+	private:
+		struct Node
+		{
+			std::atomic<Node*> next{nullptr};
+			T value;
+		};
+
+		std::atomic<Node*> head;
+		Node* tail;
+	};
+}
+
+#endif //OFXREMOTEPARAMETERS_MPSCQUEUE_H
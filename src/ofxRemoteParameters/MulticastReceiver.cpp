@@ -0,0 +1,197 @@
+//
+// Receives the OSC messages that a Server publishes to a multicast group.
+//
+
+#include "MulticastReceiver.h"
+#include "osc/OscReceivedElements.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/Timespan.h"
+
+using namespace ofxRemoteParameters;
+
+static const std::string ModuleName = "ofxRemoteParameters::MulticastReceiver";
+
+MulticastReceiver::~MulticastReceiver()
+{
+	stop();
+}
+
+bool MulticastReceiver::setup(const std::string& groupAddress, int port)
+{
+	stop();
+	try
+	{
+		group = Poco::Net::IPAddress(groupAddress);
+		if (!group.isMulticast())
+		{
+			ofLogError(ModuleName) << groupAddress << " is not a multicast address";
+			return false;
+		}
+		socket = Poco::Net::MulticastSocket();
+		// Reusing the address lets several observers on the same machine receive the same group:
+		socket.bind(Poco::Net::SocketAddress(Poco::Net::IPAddress(), port), true);
+		socket.joinGroup(group);
+		// Lets the thread check regularly whether it should stop:
+		socket.setReceiveTimeout(Poco::Timespan(0, 100000));
+	}
+	catch (const Poco::Exception& e)
+	{
+		ofLogError(ModuleName) << "Could not join multicast group " << groupAddress << ":" << port << ": "
+							   << e.displayText();
+		return false;
+	}
+
+	// The largest UDP payload, so that a model of any size that the Server could send fits:
+	buffer.resize(65536);
+	startThread();
+	return true;
+}
+
+void MulticastReceiver::stop()
+{
+	if (!isThreadRunning()) return;
+	waitForThread(true);
+	try
+	{
+		socket.leaveGroup(group);
+	}
+	catch (const Poco::Exception&)
+	{
+		// Nothing to do if the group was never joined
+	}
+	socket.close();
+}
+
+bool MulticastReceiver::getNextMessage(ofxOscMessage& message)
+{
+	if (hasWaitedMessage)
+	{
+		message = std::move(waitedMessage);
+		hasWaitedMessage = false;
+		return true;
+	}
+	return messages.tryReceive(message);
+}
+
+bool MulticastReceiver::waitForMessage(uint64_t timeoutMillis)
+{
+	if (!hasWaitedMessage)
+	{
+		hasWaitedMessage = messages.tryReceive(waitedMessage, static_cast<int64_t>(timeoutMillis));
+	}
+	return hasWaitedMessage;
+}
+
+void MulticastReceiver::threadedFunction()
+{
+	while (isThreadRunning())
+	{
+		int size;
+		try
+		{
+			size = socket.receiveBytes(buffer.data(), static_cast<int>(buffer.size()));
+		}
+		catch (const Poco::TimeoutException&)
+		{
+			continue;
+		}
+		catch (const Poco::Exception& e)
+		{
+			ofLogError(ModuleName) << "Receive failed: " << e.displayText();
+			continue;
+		}
+		if (size <= 0) continue;
+
+		try
+		{
+			processPacket(osc::ReceivedPacket(buffer.data(), size));
+		}
+		catch (const std::exception& e)
+		{
+			ofLogWarning(ModuleName) << "Ignoring malformed OSC packet: " << e.what();
+		}
+	}
+}
+
+void MulticastReceiver::processPacket(const osc::ReceivedPacket& packet)
+{
+	if (packet.IsMessage())
+	{
+		processMessage(osc::ReceivedMessage(packet));
+		return;
+	}
+
+	osc::ReceivedBundle bundle(packet);
+	for (auto element = bundle.ElementsBegin(); element != bundle.ElementsEnd(); ++element)
+	{
+		processPacket(osc::ReceivedPacket(element->Contents(), element->Size()));
+	}
+}
+
+void MulticastReceiver::processMessage(const osc::ReceivedMessage& received)
+{
+	ofxOscMessage message;
+	message.setAddress(received.AddressPattern());
+	for (auto arg = received.ArgumentsBegin(); arg != received.ArgumentsEnd(); ++arg)
+	{
+		switch (arg->TypeTag())
+		{
+			case 'i':
+				message.addInt32Arg(arg->AsInt32Unchecked());
+				break;
+			case 'h':
+				message.addInt64Arg(arg->AsInt64());
+				break;
+			case 'f':
+				message.addFloatArg(arg->AsFloatUnchecked());
+				break;
+			case 'd':
+				message.addDoubleArg(arg->AsDouble());
+				break;
+			case 's':
+				message.addStringArg(arg->AsStringUnchecked());
+				break;
+			case 'S':
+				message.addSymbolArg(arg->AsSymbol());
+				break;
+			case 'b':
+			{
+				const void* data;
+				unsigned long size;
+				arg->AsBlobUnchecked(data, size);
+				message.addBlobArg(ofBuffer(static_cast<const char*>(data), size));
+				break;
+			}
+			case 'c':
+				message.addCharArg(arg->AsChar());
+				break;
+			case 'm':
+				message.addMidiMessageArg(arg->AsMidiMessage());
+				break;
+			case 'r':
+				message.addRgbaColorArg(arg->AsRgbaColor());
+				break;
+			case 't':
+				message.addTimetagArg(arg->AsTimeTag());
+				break;
+			case 'T':
+				message.addBoolArg(true);
+				break;
+			case 'F':
+				message.addBoolArg(false);
+				break;
+			case 'N':
+				message.addNoneArg();
+				break;
+			case 'I':
+				message.addTriggerArg();
+				break;
+			default:
+				ofLogWarning(ModuleName) << "Ignoring argument of unknown type " << arg->TypeTag() << " in "
+										 << received.AddressPattern();
+				break;
+		}
+	}
+	messages.send(std::move(message));
+}
@@ -0,0 +1,69 @@
+//
+// Receives the OSC messages that a Server publishes to a multicast group.
+//
+
+#ifndef OFXREMOTEPARAMETERS_MULTICASTRECEIVER_H
+#define OFXREMOTEPARAMETERS_MULTICASTRECEIVER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ofThread.h"
+#include "ofThreadChannel.h"
+#include "ofxOsc.h"
+#include "Poco/Net/MulticastSocket.h"
+#include "Poco/Net/IPAddress.h"
+
+namespace osc
+{
+	class ReceivedPacket;
+	class ReceivedMessage;
+}
+
+namespace ofxRemoteParameters
+{
+	/**
+	 * @brief Joins a multicast group and decodes the OSC packets sent to it on a background thread. ofxOscReceiver
+	 * can't be used for this, since it doesn't join multicast groups.
+	 */
+	class MulticastReceiver : public ofThread
+	{
+	public:
+		~MulticastReceiver();
+		/**
+		 * @brief Joins the group and starts receiving.
+		 * @param groupAddress A multicast address, e.g. 239.255.0.1.
+		 * @param port The port the Server publishes to. Several receivers on the same machine can share it.
+		 * @return false if the socket could not be set up or the group could not be joined.
+		 */
+		bool setup(const std::string& groupAddress, int port);
+		void stop();
+		/**
+		 * @brief Gets the next received message, like ofxOscReceiver::getNextMessage(). Call it from the main thread.
+		 */
+		bool getNextMessage(ofxOscMessage& message);
+		/**
+		 * @brief Blocks until a message is waiting or timeoutMillis have passed. Call it from the thread that calls
+		 * getNextMessage().
+		 * @return true if a message is waiting.
+		 */
+		bool waitForMessage(uint64_t timeoutMillis);
+
+	protected:
+		void threadedFunction() override;
+
+	private:
+		void processPacket(const osc::ReceivedPacket& packet);
+		void processMessage(const osc::ReceivedMessage& message);
+
+		Poco::Net::MulticastSocket socket;
+		Poco::Net::IPAddress group;
+		ofThreadChannel<ofxOscMessage> messages;
+		/// A message taken from the channel by waitForMessage(), returned by the next getNextMessage()
+		ofxOscMessage waitedMessage;
+		bool hasWaitedMessage = false;
+		std::vector<char> buffer;
+	};
+}
+
+#endif //OFXREMOTEPARAMETERS_MULTICASTRECEIVER_H
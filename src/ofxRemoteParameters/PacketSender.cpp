@@ -0,0 +1,325 @@
+//
+// Encodes OSC messages into reusable buffers and sends them over UDP.
+//
+
+#include "PacketSender.h"
+#include <cstring>
+#include <stdexcept>
+#include "ip/UdpSocket.h"
+#include "ofLog.h"
+#include "ofUtils.h"
+#include <algorithm>
+
+using namespace ofxRemoteParameters;
+
+static const std::string ModuleName = "ofxRemoteParameters::PacketSender";
+
+OscPacketWriter& OscPacketWriter::begin(const std::string& address)
+{
+	this->address = address;
+	typeTags.assign(1, ',');
+	arguments.clear();
+	isEncoded = false;
+	return *this;
+}
+
+OscPacketWriter& OscPacketWriter::addInt32(int32_t value)
+{
+	typeTags.push_back('i');
+	appendBigEndian(static_cast<uint32_t>(value), 4);
+	return *this;
+}
+
+OscPacketWriter& OscPacketWriter::addInt64(int64_t value)
+{
+	typeTags.push_back('h');
+	appendBigEndian(static_cast<uint64_t>(value), 8);
+	return *this;
+}
+
+OscPacketWriter& OscPacketWriter::addFloat(float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	typeTags.push_back('f');
+	appendBigEndian(bits, 4);
+	return *this;
+}
+
+OscPacketWriter& OscPacketWriter::addDouble(double value)
+{
+	uint64_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	typeTags.push_back('d');
+	appendBigEndian(bits, 8);
+	return *this;
+}
+
+OscPacketWriter& OscPacketWriter::addString(const std::string& value)
+{
+	typeTags.push_back('s');
+	appendPadded(arguments, value.data(), value.size(), true);
+	return *this;
+}
+
+OscPacketWriter& OscPacketWriter::addBlob(const char* data, std::size_t size)
+{
+	typeTags.push_back('b');
+	appendBigEndian(static_cast<uint32_t>(size), 4);
+	appendPadded(arguments, data, size, false);
+	return *this;
+}
+
+void OscPacketWriter::write(const ofxOscMessage& message)
+{
+	begin(message.getAddress());
+	for (std::size_t i = 0; i < message.getNumArgs(); i++)
+	{
+		switch (message.getArgType(i))
+		{
+			case OFXOSC_TYPE_INT32:
+				addInt32(message.getArgAsInt32(i));
+				break;
+			case OFXOSC_TYPE_INT64:
+				addInt64(message.getArgAsInt64(i));
+				break;
+			case OFXOSC_TYPE_FLOAT:
+				addFloat(message.getArgAsFloat(i));
+				break;
+			case OFXOSC_TYPE_DOUBLE:
+				addDouble(message.getArgAsDouble(i));
+				break;
+			case OFXOSC_TYPE_STRING:
+				addString(message.getArgAsString(i));
+				break;
+			case OFXOSC_TYPE_SYMBOL:
+				addString(message.getArgAsSymbol(i));
+				typeTags.back() = 'S';
+				break;
+			case OFXOSC_TYPE_BLOB:
+			{
+				auto blob = message.getArgAsBlob(i);
+				addBlob(blob.getData(), blob.size());
+				break;
+			}
+			case OFXOSC_TYPE_CHAR:
+				addInt32(message.getArgAsChar(i));
+				typeTags.back() = 'c';
+				break;
+			case OFXOSC_TYPE_MIDI_MESSAGE:
+				addInt32(static_cast<int32_t>(message.getArgAsMidiMessage(i)));
+				typeTags.back() = 'm';
+				break;
+			case OFXOSC_TYPE_RGBA_COLOR:
+				addInt32(static_cast<int32_t>(message.getArgAsRgbaColor(i)));
+				typeTags.back() = 'r';
+				break;
+			case OFXOSC_TYPE_TIMETAG:
+				addInt64(static_cast<int64_t>(message.getArgAsTimetag(i)));
+				typeTags.back() = 't';
+				break;
+			case OFXOSC_TYPE_TRUE:
+			case OFXOSC_TYPE_FALSE:
+			case OFXOSC_TYPE_NONE:
+			case OFXOSC_TYPE_TRIGGER:
+				// These carry no data, only their tag:
+				typeTags.push_back(static_cast<char>(message.getArgType(i)));
+				break;
+			default:
+				ofLogWarning(ModuleName) << "Not sending argument " << i << " of " << message.getAddress()
+										 << ", its type is not supported";
+				break;
+		}
+	}
+}
+
+const char* OscPacketWriter::getData()
+{
+	if (!isEncoded)
+	{
+		packet.clear();
+		appendPadded(packet, address.data(), address.size(), true);
+		appendPadded(packet, typeTags.data(), typeTags.size(), true);
+		packet.insert(packet.end(), arguments.begin(), arguments.end());
+		isEncoded = true;
+	}
+	return packet.data();
+}
+
+std::size_t OscPacketWriter::getSize()
+{
+	getData();
+	return packet.size();
+}
+
+void OscPacketWriter::appendPadded(std::vector<char>& bytes, const char* data, std::size_t size, bool terminate)
+{
+	bytes.insert(bytes.end(), data, data + size);
+	// OSC strings are terminated with at least one null, and every element is padded to a multiple of 4 bytes:
+	auto paddedSize = terminate ? (size + 4) & ~std::size_t(3) : (size + 3) & ~std::size_t(3);
+	bytes.insert(bytes.end(), paddedSize - size, '\0');
+}
+
+void OscPacketWriter::appendBigEndian(uint64_t value, std::size_t byteCount)
+{
+	for (std::size_t i = byteCount; i > 0; i--)
+	{
+		arguments.push_back(static_cast<char>((value >> ((i - 1) * 8)) & 0xff));
+	}
+}
+
+PacketSender::PacketSender() = default;
+
+PacketSender::~PacketSender() = default;
+
+bool PacketSender::setup(const std::string& host, int port)
+{
+	clear();
+	try
+	{
+		socket = std::make_unique<UdpTransmitSocket>(IpEndpointName(host.c_str(), port));
+		// Like ofxOscSender, so that broadcast addresses keep working:
+		socket->SetEnableBroadcast(true);
+	}
+	catch (const std::exception& e)
+	{
+		ofLogError(ModuleName) << "Could not set up a socket to " << host << ":" << port << ": " << e.what();
+		socket.reset();
+		return false;
+	}
+	this->host = host;
+	this->port = port;
+	return true;
+}
+
+void PacketSender::clear()
+{
+	socket.reset();
+	host.clear();
+	port = 0;
+	while (!queue.empty())
+	{
+		spareBuffers.push_back(std::move(queue.front()));
+		queue.pop_front();
+	}
+	queuedBytes = 0;
+}
+
+void PacketSender::sendMessage(const ofxOscMessage& message)
+{
+	writer.write(message);
+	send(writer);
+}
+
+void PacketSender::send(OscPacketWriter& writer)
+{
+	sendPacket(writer.getData(), writer.getSize());
+}
+
+void PacketSender::setPacing(uint64_t bytesPerSecond, std::size_t burstBytes, std::size_t maxQueuedBytes)
+{
+	this->bytesPerSecond = bytesPerSecond;
+	this->burstBytes = burstBytes;
+	this->maxQueuedBytes = maxQueuedBytes;
+	tokens = static_cast<double>(burstBytes);
+	lastRefillMicros = ofGetElapsedTimeMicros();
+	drain();
+}
+
+void PacketSender::drain()
+{
+	if (bytesPerSecond > 0) refillTokens();
+	while (!queue.empty())
+	{
+		auto& packet = queue.front();
+		if (bytesPerSecond > 0)
+		{
+			if (tokens < static_cast<double>(std::min(packet.size(), burstBytes))) return;
+			tokens -= packet.size();
+		}
+		transmit(packet.data(), packet.size());
+		queuedBytes -= packet.size();
+		spareBuffers.push_back(std::move(packet));
+		queue.pop_front();
+	}
+}
+
+std::size_t PacketSender::getQueuedPackets() const
+{
+	return queue.size();
+}
+
+std::size_t PacketSender::getQueuedBytes() const
+{
+	return queuedBytes;
+}
+
+std::size_t PacketSender::getDroppedPackets() const
+{
+	return droppedPackets;
+}
+
+void PacketSender::sendPacket(const char* data, std::size_t size)
+{
+	if (!socket) return;
+	if (bytesPerSecond == 0)
+	{
+		transmit(data, size);
+		return;
+	}
+
+	refillTokens();
+	// Packets are only sent directly when nothing is queued, so that they stay in order
+	if (queue.empty() && tokens >= static_cast<double>(std::min(size, burstBytes)))
+	{
+		tokens -= size;
+		transmit(data, size);
+		return;
+	}
+	if (queuedBytes + size > maxQueuedBytes)
+	{
+		droppedPackets++;
+		return;
+	}
+	if (spareBuffers.empty())
+	{
+		queue.emplace_back();
+	}
+	else
+	{
+		queue.push_back(std::move(spareBuffers.back()));
+		spareBuffers.pop_back();
+	}
+	queue.back().assign(data, data + size);
+	queuedBytes += size;
+}
+
+void PacketSender::refillTokens()
+{
+	auto now = ofGetElapsedTimeMicros();
+	tokens = std::min(static_cast<double>(burstBytes),
+					  tokens + (now - lastRefillMicros) * static_cast<double>(bytesPerSecond) / 1000000.0);
+	lastRefillMicros = now;
+}
+
+void PacketSender::transmit(const char* data, std::size_t size)
+{
+	try
+	{
+		socket->Send(data, size);
+	}
+	catch (const std::exception& e)
+	{
+		ofLogError(ModuleName) << "Could not send to " << host << ":" << port << ": " << e.what();
+	}
+}
+
+const std::string& PacketSender::getHost() const
+{
+	return host;
+}
+
+int PacketSender::getPort() const
+{
+	return port;
+}
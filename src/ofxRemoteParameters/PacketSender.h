@@ -0,0 +1,129 @@
+//
+// Encodes OSC messages into reusable buffers and sends them over UDP.
+//
+
+#ifndef OFXREMOTEPARAMETERS_PACKETSENDER_H
+#define OFXREMOTEPARAMETERS_PACKETSENDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ofxOsc.h"
+
+class UdpTransmitSocket;
+
+namespace ofxRemoteParameters
+{
+	/**
+	 * @brief Encodes one OSC message at a time. Its buffers are kept from message to message, so that once they have
+	 * grown to the size of the messages, encoding doesn't allocate. ofxOscMessage allocates every argument, which is
+	 * why the hot paths write their messages with this instead.
+	 * @example writer.begin("/ofxrpMethod/set").addString(path).addString(value);
+	 */
+	class OscPacketWriter
+	{
+	public:
+		/**
+		 * @brief Starts a new message, discarding the previous one.
+		 */
+		OscPacketWriter& begin(const std::string& address);
+		OscPacketWriter& addInt32(int32_t value);
+		OscPacketWriter& addInt64(int64_t value);
+		OscPacketWriter& addFloat(float value);
+		OscPacketWriter& addDouble(double value);
+		OscPacketWriter& addString(const std::string& value);
+		OscPacketWriter& addBlob(const char* data, std::size_t size);
+		/**
+		 * @brief Starts a new message with the address and the arguments of message. This allocates, since reading
+		 * the arguments of an ofxOscMessage does.
+		 */
+		void write(const ofxOscMessage& message);
+
+		/**
+		 * @brief The encoded message, valid until the next call to begin() or write().
+		 */
+		const char* getData();
+		std::size_t getSize();
+
+	private:
+		void appendPadded(std::vector<char>& bytes, const char* data, std::size_t size, bool terminate);
+		void appendBigEndian(uint64_t value, std::size_t byteCount);
+
+		std::string address;
+		/// Starts with ',', as in the encoded message
+		std::vector<char> typeTags;
+		std::vector<char> arguments;
+		std::vector<char> packet;
+		bool isEncoded = false;
+	};
+
+	/**
+	 * @brief Sends OSC messages to one host over UDP, like ofxOscSender, but through an OscPacketWriter so that
+	 * sending doesn't allocate. The packets can be paced, see setPacing().
+	 */
+	class PacketSender
+	{
+	public:
+		PacketSender();
+		~PacketSender();
+		/**
+		 * @return false if the host could not be resolved or the socket could not be opened.
+		 */
+		bool setup(const std::string& host, int port);
+		void clear();
+		/**
+		 * @brief Encodes and sends message. Prefer send() with an OscPacketWriter on the hot paths.
+		 */
+		void sendMessage(const ofxOscMessage& message);
+		/**
+		 * @brief Sends the message encoded by writer. The same writer can be sent to several senders.
+		 */
+		void send(OscPacketWriter& writer);
+		const std::string& getHost() const;
+		int getPort() const;
+
+		/**
+		 * @brief Paces the packets with a token bucket, so that slow receivers aren't flooded: up to burstBytes
+		 * are sent at once, and bytesPerSecond on average. Packets over the budget are queued, in order, and sent
+		 * by drain(), so that sending never blocks. New packets are dropped while maxQueuedBytes are queued.
+		 * A packet larger than burstBytes is sent once the bucket is full.
+		 * @param bytesPerSecond The average rate, or 0 to disable pacing and send the queued packets right away.
+		 */
+		void setPacing(uint64_t bytesPerSecond, std::size_t burstBytes, std::size_t maxQueuedBytes);
+		/**
+		 * @brief Sends the queued packets that the budget allows. Call it regularly while pacing.
+		 */
+		void drain();
+		std::size_t getQueuedPackets() const;
+		std::size_t getQueuedBytes() const;
+		/// The packets dropped because the queue was full, since the sender was created
+		std::size_t getDroppedPackets() const;
+
+	private:
+		void sendPacket(const char* data, std::size_t size);
+		void transmit(const char* data, std::size_t size);
+		void refillTokens();
+
+		std::unique_ptr<UdpTransmitSocket> socket;
+		OscPacketWriter writer;
+		std::string host;
+		int port = 0;
+
+		uint64_t bytesPerSecond = 0;
+		std::size_t burstBytes = 0;
+		std::size_t maxQueuedBytes = 0;
+		/// Can go negative after a packet larger than the burst
+		double tokens = 0;
+		uint64_t lastRefillMicros = 0;
+		std::deque<std::vector<char>> queue;
+		/// The buffers of the packets sent from the queue, reused for the next ones
+		std::vector<std::vector<char>> spareBuffers;
+		std::size_t queuedBytes = 0;
+		std::size_t droppedPackets = 0;
+	};
+}
+
+#endif //OFXREMOTEPARAMETERS_PACKETSENDER_H
@@ -0,0 +1,223 @@
+//
+// A flat index of a parameter tree, with interned names.
+//
+
+#include "ParameterTable.h"
+
+using namespace ofxRemoteParameters;
+
+namespace
+{
+	/// Splits the first component off path, skipping leading slashes.
+	std::string_view nextComponent(std::string_view& path)
+	{
+		auto begin = path.find_first_not_of('/');
+		if (begin == std::string_view::npos)
+		{
+			path = std::string_view();
+			return std::string_view();
+		}
+		auto end = path.find('/', begin);
+		if (end == std::string_view::npos) end = path.size();
+		auto component = path.substr(begin, end - begin);
+		path.remove_prefix(end);
+		return component;
+	}
+
+	/// Rough heap cost of a node of a std::unordered_map, plus its bucket
+	template<typename Key, typename Value>
+	constexpr std::size_t hashNodeBytes()
+	{
+		return sizeof(void*) * 2 + sizeof(std::size_t) + sizeof(std::pair<const Key, Value>);
+	}
+}
+
+NameTable::Id NameTable::intern(const std::string& name)
+{
+	auto iter = ids.find(name);
+	if (iter != ids.end()) return iter->second;
+	names.push_back(name);
+	auto id = static_cast<Id>(names.size() - 1);
+	ids.emplace(names.back(), id);
+	return id;
+}
+
+NameTable::Id NameTable::find(std::string_view name) const
+{
+	auto iter = ids.find(name);
+	return iter != ids.end() ? iter->second : NotFound;
+}
+
+void NameTable::clear()
+{
+	ids.clear();
+	names.clear();
+}
+
+std::size_t NameTable::getMemoryBytes() const
+{
+	std::size_t bytes = names.size() * sizeof(std::string) + ids.size() * hashNodeBytes<std::string_view, Id>();
+	for (auto& name : names)
+	{
+		// Short names are stored inside the string
+		if (name.capacity() >= sizeof(std::string)) bytes += name.capacity() + 1;
+	}
+	return bytes;
+}
+
+void ParameterTable::build(const std::shared_ptr<ofParameterGroup>& root, const TypeResolver& resolveType)
+{
+	clear();
+	add(root, NoEntry, 0, resolveType);
+}
+
+void ParameterTable::clear()
+{
+	entries.clear();
+	valueEntries.clear();
+	children.clear();
+	names.clear();
+}
+
+void ParameterTable::add(const std::shared_ptr<ofAbstractParameter>& parameter,
+						 Index parent,
+						 Index position,
+						 const TypeResolver& resolveType)
+{
+	auto index = static_cast<Index>(entries.size());
+	entries.emplace_back();
+	{
+		auto& entry = entries.back();
+		entry.parameter = parameter;
+		entry.parent = parent;
+		entry.position = position;
+		// getEscapedName() and getName() build a new string on every call, so they are only called here:
+		entry.escapedName = names.intern(parameter->getEscapedName());
+		entry.name = names.intern(parameter->getName());
+		entry.valueBegin = static_cast<Index>(valueEntries.size());
+		entry.typeId = CustomTypeId;
+		entry.isGroup = false;
+		entry.isRegistered = false;
+	}
+	// Like the linear search that it replaces, the first of several children with the same name wins:
+	if (parent != NoEntry) children.emplace(childKey(parent, entries[index].escapedName), index);
+
+	auto group = std::dynamic_pointer_cast<ofParameterGroup>(parameter);
+	if (group)
+	{
+		entries[index].isGroup = true;
+		Index position = 0;
+		for (auto& child : *group)
+		{
+			add(child, index, position++, resolveType);
+		}
+	}
+	else
+	{
+		TypeId typeId = CustomTypeId;
+		if (resolveType(*parameter, typeId))
+		{
+			entries[index].typeId = typeId;
+			entries[index].isRegistered = true;
+			valueEntries.push_back(index);
+		}
+	}
+	// entries may have grown since the entry was added:
+	auto& entry = entries[index];
+	entry.subtreeEnd = static_cast<Index>(entries.size());
+	entry.valueEnd = static_cast<Index>(valueEntries.size());
+}
+
+bool ParameterTable::matches(const std::shared_ptr<ofParameterGroup>& root, const TypeResolver& resolveType) const
+{
+	Index index = 0;
+	return matches(root, index, resolveType) && index == entries.size();
+}
+
+bool ParameterTable::matches(const std::shared_ptr<ofAbstractParameter>& parameter,
+							 Index& index,
+							 const TypeResolver& resolveType) const
+{
+	if (index >= entries.size()) return false;
+	auto& entry = entries[index++];
+	// Parameters can be renamed in place, so the same parameter isn't enough:
+	if (entry.parameter != parameter || parameter->getName() != names.get(entry.name)) return false;
+
+	auto group = dynamic_cast<ofParameterGroup*>(parameter.get());
+	if (entry.isGroup != (group != nullptr)) return false;
+	if (group)
+	{
+		for (auto& child : *group)
+		{
+			if (!matches(child, index, resolveType)) return false;
+		}
+		return index == entry.subtreeEnd;
+	}
+	// A type registered since the table was built adds the parameter to the model
+	TypeId typeId = CustomTypeId;
+	bool isRegistered = resolveType(*parameter, typeId);
+	return isRegistered == entry.isRegistered && typeId == entry.typeId;
+}
+
+ParameterTable::Index ParameterTable::find(std::string_view path) const
+{
+	if (entries.empty()) return NoEntry;
+	auto component = nextComponent(path);
+	if (component.empty() || component != names.get(entries[0].escapedName)) return NoEntry;
+
+	Index current = 0;
+	for (component = nextComponent(path); !component.empty(); component = nextComponent(path))
+	{
+		auto name = names.find(component);
+		if (name == NameTable::NotFound) return NoEntry;
+		auto child = children.find(childKey(current, name));
+		if (child == children.end()) return NoEntry;
+		current = child->second;
+	}
+	return current;
+}
+
+void ParameterTable::getPath(Index index, std::string& path) const
+{
+	path.clear();
+	if (index == NoEntry) return;
+	// Walks up to the root, then writes the names from the root down:
+	std::size_t length = 0;
+	for (auto i = index; i != NoEntry; i = entries[i].parent)
+	{
+		length += names.get(entries[i].escapedName).size() + 1;
+	}
+	path.resize(length);
+	auto end = length;
+	for (auto i = index; i != NoEntry; i = entries[i].parent)
+	{
+		auto& name = names.get(entries[i].escapedName);
+		end -= name.size();
+		path.replace(end, name.size(), name);
+		path[--end] = '/';
+	}
+}
+
+bool ParameterTable::isAttached(Index index) const
+{
+	for (auto i = index; i != NoEntry; i = entries[i].parent)
+	{
+		auto& entry = entries[i];
+		if (entry.parameter->getName() != names.get(entry.name)) return false;
+		if (entry.parent == NoEntry) break;
+		auto& parentGroup = static_cast<ofParameterGroup&>(*entries[entry.parent].parameter);
+		if (entry.position >= parentGroup.size() || &parentGroup.get(entry.position) != entry.parameter.get())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+std::size_t ParameterTable::getMemoryBytes() const
+{
+	return entries.capacity() * sizeof(Entry) +
+		   valueEntries.capacity() * sizeof(Index) +
+		   children.size() * hashNodeBytes<uint64_t, Index>() +
+		   names.getMemoryBytes();
+}
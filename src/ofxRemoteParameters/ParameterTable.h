@@ -0,0 +1,154 @@
+//
+// A flat index of a parameter tree, with interned names.
+//
+
+#ifndef OFXREMOTEPARAMETERS_PARAMETERTABLE_H
+#define OFXREMOTEPARAMETERS_PARAMETERTABLE_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "ofParameter.h"
+#include "ParameterTypes.h"
+
+namespace ofxRemoteParameters
+{
+	/**
+	 * @brief Stores every distinct name once. Large trees repeat the same few names (e.g. "Intensity" in every
+	 * light), so interning them takes a fraction of the memory of a string per parameter.
+	 */
+	class NameTable
+	{
+	public:
+		using Id = uint32_t;
+		static const Id NotFound = static_cast<Id>(-1);
+
+		Id intern(const std::string& name);
+		/**
+		 * @return The id of name, or NotFound if it was never interned. Doesn't allocate.
+		 */
+		Id find(std::string_view name) const;
+		const std::string& get(Id id) const { return names[id]; }
+		std::size_t size() const { return names.size(); }
+		void clear();
+		/**
+		 * @brief An estimate of the heap memory used by the table.
+		 */
+		std::size_t getMemoryBytes() const;
+
+	private:
+		/// A deque, so that the names don't move and the views in ids stay valid
+		std::deque<std::string> names;
+		std::unordered_map<std::string_view, Id> ids;
+	};
+
+	/**
+	 * @brief The groups and parameters of a tree in model order, in one array. Each entry refers to its parent by
+	 * index and to its names by id, instead of holding path strings, and paths are resolved one component at a
+	 * time through a hash table keyed by (parent, name). The parameters of registered types are numbered in model
+	 * order: these are their ids in the model, and the index of getValue().
+	 */
+	class ParameterTable
+	{
+	public:
+		using Index = uint32_t;
+		static const Index NoEntry = static_cast<Index>(-1);
+
+		struct Entry
+		{
+			std::shared_ptr<ofAbstractParameter> parameter;
+			/// The group that contains the entry, NoEntry for the root
+			Index parent;
+			/// The index after the subtree of the entry, which is the next sibling if there is one
+			Index subtreeEnd;
+			/// The position of the parameter in its parent group
+			Index position;
+			NameTable::Id escapedName;
+			NameTable::Id name;
+			/// The ids of the parameters of registered types in the subtree are [valueBegin, valueEnd). For such a
+			/// parameter, valueBegin is its id.
+			Index valueBegin;
+			Index valueEnd;
+			TypeId typeId;
+			bool isGroup;
+			/// Whether the type of the parameter is registered. Parameters of other types are left out of the model.
+			bool isRegistered;
+		};
+
+		/**
+		 * @brief Returns whether the type of the parameter is registered, and sets its TypeId.
+		 */
+		using TypeResolver = std::function<bool(const ofAbstractParameter& parameter, TypeId& typeId)>;
+
+		void build(const std::shared_ptr<ofParameterGroup>& root, const TypeResolver& resolveType);
+		void clear();
+		/**
+		 * @brief Whether building the table from root would give the same entries: the same parameters, in the same
+		 * order, with the same names and types. This is much cheaper than building it, and the ids stay the same if
+		 * it returns true.
+		 */
+		bool matches(const std::shared_ptr<ofParameterGroup>& root, const TypeResolver& resolveType) const;
+
+		std::size_t size() const { return entries.size(); }
+		const Entry& operator[](Index index) const { return entries[index]; }
+		std::size_t getValueCount() const { return valueEntries.size(); }
+		/**
+		 * @param id The id of a parameter, from 0 to getValueCount().
+		 */
+		const Entry& getValue(Index id) const { return entries[valueEntries[id]]; }
+		Index getValueEntry(Index id) const { return valueEntries[id]; }
+
+		/**
+		 * @return The entry at path, e.g. "/Root/Group/Parameter", or NoEntry. Doesn't allocate.
+		 */
+		Index find(std::string_view path) const;
+		/**
+		 * @brief Writes the path of the entry into path, reusing its capacity.
+		 */
+		void getPath(Index index, std::string& path) const;
+		/**
+		 * @brief Whether the entry and the groups above it are still where the table found them: at the same
+		 * position of the same parent, with the same name. A parameter that was removed, replaced or renamed since
+		 * the table was built is detached, and must not be reached through the table anymore. Names are compared
+		 * through getName(), which copies them, so this only allocates for long names.
+		 */
+		bool isAttached(Index index) const;
+		const std::string& getEscapedName(const Entry& entry) const { return names.get(entry.escapedName); }
+		const std::string& getName(const Entry& entry) const { return names.get(entry.name); }
+
+		/**
+		 * @brief An estimate of the heap memory used by the table, names included.
+		 */
+		std::size_t getMemoryBytes() const;
+
+	private:
+		void add(const std::shared_ptr<ofAbstractParameter>& parameter,
+				 Index parent,
+				 Index position,
+				 const TypeResolver& resolveType);
+		/**
+		 * @brief Compares the subtree of parameter with the entries from index on, and moves index past it.
+		 */
+		bool matches(const std::shared_ptr<ofAbstractParameter>& parameter,
+					 Index& index,
+					 const TypeResolver& resolveType) const;
+
+		static uint64_t childKey(Index parent, NameTable::Id name)
+		{
+			return (static_cast<uint64_t>(parent) << 32) | name;
+		}
+
+		NameTable names;
+		std::vector<Entry> entries;
+		std::vector<Index> valueEntries;
+		/// (parent, escaped name) to the entry, for find()
+		std::unordered_map<uint64_t, Index> children;
+	};
+}
+
+#endif //OFXREMOTEPARAMETERS_PARAMETERTABLE_H
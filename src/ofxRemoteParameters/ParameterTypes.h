@@ -0,0 +1,282 @@
+//
+// Compile-time description of the parameter types shared by Server and Client.
+//
+
+#ifndef OFXREMOTEPARAMETERS_PARAMETERTYPES_H
+#define OFXREMOTEPARAMETERS_PARAMETERTYPES_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "ofParameter.h"
+#include "ofColor.h"
+#include "ofRectangle.h"
+#include "ofQuaternion.h"
+#include "ofMatrix3x3.h"
+#include "ofMatrix4x4.h"
+#include "ofVectorMath.h"
+#include "ArrayTypes.h"
+
+namespace ofxRemoteParameters
+{
+	/**
+	 * @brief A compile-time list of parameter types, used to register several types at once with
+	 * Server::addParameterTypes() and Client::addParameterTypes().
+	 */
+	template<typename... Types>
+	struct TypeList
+	{
+		static constexpr std::size_t size = sizeof...(Types);
+	};
+
+	template<typename T>
+	struct TypeTag
+	{
+		using type = T;
+	};
+
+	/**
+	 * @brief Describes how a type is named in the model. Specialize it for your own types to register them with
+	 * addParameterTypes(). Server and Client both read the name from here, so they are guaranteed to agree:
+	 * @code
+	 * template<>
+	 * struct ofxRemoteParameters::TypeTraits<MyType>
+	 * {
+	 * 	static constexpr const char* name = "myType";
+	 * 	static constexpr bool hasLimits = false;
+	 * };
+	 * @endcode
+	 */
+	template<typename T>
+	struct TypeTraits;
+
+#define OFXREMOTEPARAMETERS_TYPE_TRAITS(Type, typeName, limits) \
+	template<> \
+	struct TypeTraits<Type> \
+	{ \
+		static constexpr const char* name = typeName; \
+		static constexpr bool hasLimits = limits; \
+	};
+
+	OFXREMOTEPARAMETERS_TYPE_TRAITS(int, "int", true)
+	OFXREMOTEPARAMETERS_TYPE_TRAITS(float, "float", true)
+	OFXREMOTEPARAMETERS_TYPE_TRAITS(double, "double", true)
+	OFXREMOTEPARAMETERS_TYPE_TRAITS(ofColor, "color", false)
+	OFXREMOTEPARAMETERS_TYPE_TRAITS(ofFloatColor, "floatColor", false)
+	OFXREMOTEPARAMETERS_TYPE_TRAITS(ofParameterGroup, "group", false)
+	OFXREMOTEPARAMETERS_TYPE_TRAITS(std::string, "string", false)
+	OFXREMOTEPARAMETERS_TYPE_TRAITS(bool, "boolean", false)
+	OFXREMOTEPARAMETERS_TYPE_TRAITS(glm::vec2, "vec2", true)
+	OFXREMOTEPARAMETERS_TYPE_TRAITS(glm::vec3, "vec3", true)
+	OFXREMOTEPARAMETERS_TYPE_TRAITS(glm::vec4, "vec4", true)
+	OFXREMOTEPARAMETERS_TYPE_TRAITS(ofRectangle, "ofRectangle", false)
+	OFXREMOTEPARAMETERS_TYPE_TRAITS(ofQuaternion, "ofQuaternion", false)
+	OFXREMOTEPARAMETERS_TYPE_TRAITS(ofMatrix3x3, "ofMatrix3x3", false)
+	OFXREMOTEPARAMETERS_TYPE_TRAITS(ofMatrix4x4, "ofMatrix4x4", false)
+	OFXREMOTEPARAMETERS_TYPE_TRAITS(std::vector<int>, "intArray", false)
+	OFXREMOTEPARAMETERS_TYPE_TRAITS(std::vector<float>, "floatArray", false)
+	OFXREMOTEPARAMETERS_TYPE_TRAITS(std::vector<glm::vec2>, "vec2Array", false)
+	OFXREMOTEPARAMETERS_TYPE_TRAITS(std::vector<glm::vec3>, "vec3Array", false)
+	OFXREMOTEPARAMETERS_TYPE_TRAITS(std::vector<glm::vec4>, "vec4Array", false)
+
+#undef OFXREMOTEPARAMETERS_TYPE_TRAITS
+
+	/**
+	 * @brief The types that Server and Client support out of the box. The position of a type in this list is its
+	 * TypeId.
+	 */
+	using BuiltinTypes = TypeList<int,
+								  float,
+								  double,
+								  ofColor,
+								  ofFloatColor,
+								  ofParameterGroup,
+								  std::string,
+								  bool,
+								  glm::vec2,
+								  glm::vec3,
+								  glm::vec4,
+								  ofRectangle,
+								  ofQuaternion,
+								  ofMatrix3x3,
+								  ofMatrix4x4,
+								  std::vector<int>,
+								  std::vector<float>,
+								  std::vector<glm::vec2>,
+								  std::vector<glm::vec3>,
+								  std::vector<glm::vec4>>;
+
+	/**
+	 * @brief The array types among BuiltinTypes. See ArrayTraits.
+	 */
+	using ArrayTypes = TypeList<std::vector<int>,
+								std::vector<float>,
+								std::vector<glm::vec2>,
+								std::vector<glm::vec3>,
+								std::vector<glm::vec4>>;
+
+	/**
+	 * @brief A dense identifier for the built-in types, used to dispatch on a type with a switch instead of a
+	 * hash lookup and an indirect call.
+	 */
+	using TypeId = uint8_t;
+	const TypeId CustomTypeId = 0xFF;
+
+	namespace priv
+	{
+		template<typename T, typename List>
+		struct TypeIndexOf;
+
+		template<typename T>
+		struct TypeIndexOf<T, TypeList<>>
+		{
+			static constexpr TypeId value = CustomTypeId;
+		};
+
+		template<typename T, typename... Rest>
+		struct TypeIndexOf<T, TypeList<T, Rest...>>
+		{
+			static constexpr TypeId value = 0;
+		};
+
+		template<typename T, typename First, typename... Rest>
+		struct TypeIndexOf<T, TypeList<First, Rest...>>
+		{
+			static constexpr TypeId next = TypeIndexOf<T, TypeList<Rest...>>::value;
+			static constexpr TypeId value = next == CustomTypeId ? CustomTypeId : next + 1;
+		};
+
+		template<typename... Types, std::size_t... Indices, typename Function>
+		bool dispatch(TypeList<Types...>, std::index_sequence<Indices...>, TypeId id, Function& function)
+		{
+			// Expands to a chain of comparisons against constants, which the compiler turns into a switch
+			return ((id == Indices ? (function(TypeTag<Types>()), true) : false) || ...);
+		}
+	}
+
+	/**
+	 * @brief The TypeId of T, or CustomTypeId if T is not a built-in type.
+	 */
+	template<typename T>
+	constexpr TypeId builtinTypeId()
+	{
+		return priv::TypeIndexOf<T, BuiltinTypes>::value;
+	}
+
+	/**
+	 * @brief Calls function(TypeTag<T>()) for the built-in type T with the given id.
+	 * @return false if id is not the id of a built-in type.
+	 */
+	template<typename Function>
+	bool dispatchBuiltinType(TypeId id, Function&& function)
+	{
+		return priv::dispatch(BuiltinTypes(), std::make_index_sequence<BuiltinTypes::size>(), id, function);
+	}
+
+	/**
+	 * @brief Same result as ofFromString<T>(), but scalars are parsed with the C library instead of going through an
+	 * std::stringstream.
+	 */
+	template<typename T>
+	T valueFromString(const std::string& value)
+	{
+		if constexpr (std::is_same<T, int>::value)
+		{
+			return static_cast<int>(std::strtol(value.c_str(), nullptr, 10));
+		}
+		else if constexpr (std::is_same<T, float>::value)
+		{
+			return std::strtof(value.c_str(), nullptr);
+		}
+		else if constexpr (std::is_same<T, double>::value)
+		{
+			return std::strtod(value.c_str(), nullptr);
+		}
+		else if constexpr (std::is_same<T, std::string>::value)
+		{
+			return value;
+		}
+		else if constexpr (ArrayTraits<T>::isArray)
+		{
+			return arrayFromString<typename ArrayTraits<T>::ElementType>(value);
+		}
+		else
+		{
+			return ofFromString<T>(value);
+		}
+	}
+
+	/**
+	 * @brief Same as ofToString<T>(), except for the array types, which OF can't (de)serialize. The numbers are
+	 * formatted without the ostringstream of ofToString(), with the same output, so that they fit in the small
+	 * string buffer and don't allocate.
+	 */
+	template<typename T>
+	std::string valueToString(const T& value)
+	{
+		if constexpr (ArrayTraits<T>::isArray)
+		{
+			return arrayToString(value);
+		}
+		else if constexpr (std::is_same<T, int>::value)
+		{
+			return std::to_string(value);
+		}
+		else if constexpr (std::is_same<T, float>::value || std::is_same<T, double>::value)
+		{
+			// The default format of an ostream is %g with a precision of 6:
+			char buffer[32];
+			std::snprintf(buffer, sizeof(buffer), "%g", static_cast<double>(value));
+			return buffer;
+		}
+		else
+		{
+			return ofToString(value);
+		}
+	}
+
+	namespace priv
+	{
+		template<typename T, typename = void>
+		struct IsEqualityComparable : std::false_type
+		{
+		};
+
+		template<typename T>
+		struct IsEqualityComparable<T, std::void_t<decltype(std::declval<const T&>() == std::declval<const T&>())>>
+				: std::true_type
+		{
+		};
+	}
+
+	/**
+	 * @brief Compares two values with operator==, for types that have one.
+	 * @return false for types that can't be compared, so that their values are always treated as changed.
+	 */
+	template<typename T>
+	bool valuesEqual(const T& a, const T& b)
+	{
+		if constexpr (priv::IsEqualityComparable<T>::value)
+		{
+			return static_cast<bool>(a == b);
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	/**
+	 * @brief Calls function(TypeTag<T>()) for every type T in the list.
+	 */
+	template<typename... Types, typename Function>
+	void forEachType(TypeList<Types...>, Function&& function)
+	{
+		(function(TypeTag<Types>()), ...);
+	}
+}
+
+#endif //OFXREMOTEPARAMETERS_PARAMETERTYPES_H
@@ -0,0 +1,91 @@
+//
+// Routes parameter paths to handlers through a trie of path components.
+//
+
+#include "PathRouter.h"
+#include <algorithm>
+
+using namespace ofxRemoteParameters;
+
+namespace
+{
+	/// Splits the first component off path, skipping leading slashes.
+	std::string_view nextComponent(std::string_view& path)
+	{
+		auto begin = path.find_first_not_of('/');
+		if (begin == std::string_view::npos)
+		{
+			path = std::string_view();
+			return std::string_view();
+		}
+		auto end = path.find('/', begin);
+		if (end == std::string_view::npos) end = path.size();
+		auto component = path.substr(begin, end - begin);
+		path.remove_prefix(end);
+		return component;
+	}
+
+	template<typename Children>
+	auto findChild(Children& children, std::string_view component)
+	{
+		return std::lower_bound(children.begin(), children.end(), component,
+								[](const typename Children::value_type& child, std::string_view value)
+								{
+									return std::string_view(child.first) < value;
+								});
+	}
+}
+
+void PathRouter::add(std::string_view pattern, Handler handler)
+{
+	auto node = &root;
+	auto remaining = pattern;
+	for (auto component = nextComponent(remaining); !component.empty(); component = nextComponent(remaining))
+	{
+		if (component == "*")
+		{
+			if (!node->wildcard) node->wildcard = std::make_unique<Node>();
+			node = node->wildcard.get();
+			continue;
+		}
+
+		auto child = findChild(node->children, component);
+		if (child == node->children.end() || child->first != component)
+		{
+			child = node->children.emplace(child, std::string(component), std::make_unique<Node>());
+		}
+		node = child->second.get();
+	}
+	node->handler = std::move(handler);
+	isEmpty = false;
+}
+
+bool PathRouter::route(std::string_view path, std::string_view value) const
+{
+	if (isEmpty) return false;
+	auto node = match(root, path);
+	if (!node) return false;
+	node->handler(path, value);
+	return true;
+}
+
+const PathRouter::Node* PathRouter::match(const Node& node, std::string_view remaining) const
+{
+	auto component = nextComponent(remaining);
+	if (component.empty())
+	{
+		return node.handler ? &node : nullptr;
+	}
+
+	auto child = findChild(node.children, component);
+	if (child != node.children.end() && child->first == component)
+	{
+		auto result = match(*child->second, remaining);
+		if (result) return result;
+	}
+	if (node.wildcard)
+	{
+		return match(*node.wildcard, remaining);
+	}
+	return nullptr;
+}
@@ -0,0 +1,62 @@
+//
+// Routes parameter paths to handlers through a trie of path components.
+//
+
+#ifndef OFXREMOTEPARAMETERS_PATHROUTER_H
+#define OFXREMOTEPARAMETERS_PATHROUTER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ofxRemoteParameters
+{
+	/**
+	 * @brief Matches paths against patterns like "/Scene/Lights/ * /intensity" (without the spaces), where `*` matches
+	 * exactly one path component. Matching walks a trie one component at a time and doesn't allocate.
+	 * When several patterns match, components that match exactly win over `*`: the exact branch is tried first, and
+	 * the `*` branch only if it fails further down. When no patterns overlap that way, matching takes time
+	 * proportional to the length of the path; otherwise it can visit every trie node that the path could reach, but
+	 * each at most once, so it never takes longer than a walk of the whole trie.
+	 */
+	class PathRouter
+	{
+	public:
+		/**
+		 * @brief The views are only valid during the call.
+		 */
+		using Handler = std::function<void(std::string_view path, std::string_view value)>;
+
+		/**
+		 * @brief Adds a route, or replaces the handler of an existing one.
+		 */
+		void add(std::string_view pattern, Handler handler);
+
+		/**
+		 * @brief Calls the handler of the route that matches path.
+		 * @return false if no route matches.
+		 */
+		bool route(std::string_view path, std::string_view value) const;
+
+		bool empty() const { return isEmpty; }
+
+	private:
+		struct Node
+		{
+			/// Sorted by component, for binary search
+			std::vector<std::pair<std::string, std::unique_ptr<Node>>> children;
+			std::unique_ptr<Node> wildcard;
+			Handler handler;
+		};
+
+		const Node* match(const Node& node, std::string_view remaining) const;
+
+		Node root;
+		bool isEmpty = true;
+	};
+}
+
+#endif //OFXREMOTEPARAMETERS_PATHROUTER_H
@@ -0,0 +1,73 @@
+//
+// An ofxOscReceiver that decodes parameter sets into pooled entries.
+//
+
+#include "PooledOscReceiver.h"
+#include <cstring>
+#include "osc/OscReceivedElements.h"
+#include "ofxRemoteParameters.h"
+
+using namespace ofxRemoteParameters;
+
+bool PooledOscReceiver::receive(Entries& entries)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (received.empty()) return false;
+	// Swapping hands the filled vector over and keeps the capacity of both:
+	std::swap(received, entries);
+	return true;
+}
+
+void PooledOscReceiver::recycle(Entries& entries)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	for (auto& entry : entries)
+	{
+		pool.push_back(std::move(entry));
+	}
+	entries.clear();
+}
+
+std::unique_ptr<PooledOscReceiver::Entry> PooledOscReceiver::takeEntry()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (pool.empty()) return std::make_unique<Entry>();
+	auto entry = std::move(pool.back());
+	pool.pop_back();
+	return entry;
+}
+
+void PooledOscReceiver::ProcessMessage(const osc::ReceivedMessage& message, const IpEndpointName& remoteEndpoint)
+{
+	static const std::string setAddress = ApiRoot + "/" + MethodSetParam;
+	static const std::string setByIdAddress = ApiRoot + "/" + MethodSetById;
+	auto entry = takeEntry();
+	entry->isSet = false;
+	entry->id = -1;
+	if (setAddress == message.AddressPattern() && std::strcmp(message.TypeTags(), "ss") == 0)
+	{
+		auto arg = message.ArgumentsBegin();
+		entry->path.assign(arg->AsStringUnchecked());
+		++arg;
+		entry->value.assign(arg->AsStringUnchecked());
+		entry->isSet = true;
+	}
+	else if (setByIdAddress == message.AddressPattern() && std::strcmp(message.TypeTags(), "iis") == 0)
+	{
+		auto arg = message.ArgumentsBegin();
+		entry->modelKey = arg->AsInt32Unchecked();
+		++arg;
+		entry->id = arg->AsInt32Unchecked();
+		++arg;
+		entry->value.assign(arg->AsStringUnchecked());
+		entry->isSet = true;
+	}
+	else
+	{
+		// ofxOscReceiver queues the decoded message, and this is the only thread that takes it back out:
+		ofxOscReceiver::ProcessMessage(message, remoteEndpoint);
+		getNextMessage(entry->message);
+	}
+	std::unique_lock<std::mutex> lock(mutex);
+	received.push_back(std::move(entry));
+}
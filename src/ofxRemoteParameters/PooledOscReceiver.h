@@ -0,0 +1,64 @@
+//
+// An ofxOscReceiver that decodes parameter sets into pooled entries.
+//
+
+#ifndef OFXREMOTEPARAMETERS_POOLEDOSCRECEIVER_H
+#define OFXREMOTEPARAMETERS_POOLEDOSCRECEIVER_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ofxOsc.h"
+
+namespace ofxRemoteParameters
+{
+	/**
+	 * @brief Receives the messages of the Server. ofxOscReceiver allocates an ofxOscMessage with an allocation per
+	 * argument for every message, so the set messages, which make up the bulk of the traffic, are instead decoded
+	 * straight into entries that are recycled, and their strings keep their capacity. Once the pool has warmed up,
+	 * receiving a set doesn't allocate. The other messages are decoded by ofxOscReceiver as usual, and the entries
+	 * keep the order in which all of them arrived.
+	 */
+	class PooledOscReceiver : public ofxOscReceiver
+	{
+	public:
+		struct Entry
+		{
+			/// Whether this is a set, with path and value, or id and model key for setById. Otherwise the message is
+			/// in message.
+			bool isSet = false;
+			std::string path;
+			std::string value;
+			/// -1 for a set by path
+			int32_t id = -1;
+			int32_t modelKey = 0;
+			ofxOscMessage message;
+		};
+		using Entries = std::vector<std::unique_ptr<Entry>>;
+
+		/**
+		 * @brief Moves the entries received since the last call into entries, which must be empty, in the order
+		 * they arrived. Give them back with recycle() once they have been handled.
+		 * @return false if nothing was received.
+		 */
+		bool receive(Entries& entries);
+		/**
+		 * @brief Returns the entries to the pool, and empties entries.
+		 */
+		void recycle(Entries& entries);
+
+	protected:
+		void ProcessMessage(const osc::ReceivedMessage& message, const IpEndpointName& remoteEndpoint) override;
+
+	private:
+		std::unique_ptr<Entry> takeEntry();
+
+		std::mutex mutex;
+		Entries received;
+		Entries pool;
+	};
+}
+
+#endif //OFXREMOTEPARAMETERS_POOLEDOSCRECEIVER_H
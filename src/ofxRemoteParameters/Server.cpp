@@ -3,6 +3,10 @@
 //
 
 #include "Server.h"
+#include <atomic>
+#include <cstdlib>
+#include <random>
+#include <thread>
 
 using namespace ofxRemoteParameters;
 
@@ -13,35 +17,73 @@ const std::string Server::AttributeName_Type = "type";
 const std::string Server::NodeName_Value = "value";
 const std::string Server::NodeName_Min = "min";
 const std::string Server::NodeName_Max = "max";
+const std::string Server::NodeName_Argument = "argument";
+const std::string Server::AttributeName_Info = "info";
+const std::string Server::AttributeName_Default = "default";
+const std::string Server::AttributeName_Id = ModelAttributeId;
+const std::string Server::AttributeName_ModelKey = ModelAttributeModelKey;
+
+/// Below this many parameters, starting threads costs more than parallel serialization saves
+static const std::size_t ParallelSerializationMinimum = 2048;
 
 
 Server::Server()
 {
+	// Lets a reconnecting Client tell a restarted Server apart from the one it was talking to:
+	std::random_device randomDevice;
+	instanceId = ofToHex(randomDevice()) + ofToHex(ofGetSystemTimeMicros());
+	setModelRevision(0);
+
 	addServerMethod(ServerMethod(
-			"getModel",
+			MethodGetModel,
 			"Get model",
 			[this](ServerMethod& method, ofxOscMessage& inMessage, Server& server)
 			{
+				clientAcceptsCompression = inMessage.getNumArgs() > 0 &&
+										   inMessage.getArgType(0) == OFXOSC_TYPE_STRING &&
+										   inMessage.getArgAsString(0) == ModelEncodingDeflate;
+				if (frameBudgetMicros > 0)
+				{
+					// The reply is sent by update() once the model has been serialized over as many frames as needed
+					if (!modelJob.active) startModelSerialization();
+					modelJob.compress = (modelJob.pendingRequests == 0 || modelJob.compress) && clientAcceptsCompression;
+					modelJob.pendingRequests++;
+					return;
+				}
 				ofxOscMessage outMessage;
-				auto xml = createMetaModel();
-				outMessage.addStringArg(xml.toString());
+				addModelArgument(outMessage, createMetaModel(), clientAcceptsCompression);
+				outMessage.addStringArg(getModelIdentity());
 				outMessage.setRemoteEndpoint(inMessage.getRemoteHost(), outPort);
 				server.sendReply(method, outMessage);
 			}));
 
 	addServerMethod(ServerMethod(
-			"connect",
+			MethodConnect,
 			"Connect",
 			[this](ServerMethod& method, ofxOscMessage& inMessage, Server& server)
 			{
 				oscSender.setup(inMessage.getRemoteHost(), outPort);
+				hasClient = true;
+				// The new Client gets its values with the model, not from the updates sent to the previous one:
+				updateFilters.clear();
 				ofxOscMessage outMessage;
 				outMessage.addStringArg("OK");
+				outMessage.addStringArg(getModelIdentity());
+				server.sendReply(method, outMessage);
+			}));
+
+	addServerMethod(ServerMethod(
+			MethodHeartbeat,
+			"Heartbeat",
+			[this](ServerMethod& method, ofxOscMessage& inMessage, Server& server)
+			{
+				ofxOscMessage outMessage;
+				outMessage.addStringArg(getModelIdentity());
 				server.sendReply(method, outMessage);
 			}));
 
 	addServerMethod(ServerMethod(
-			"set",
+			MethodSetParam,
 			"Set parameter",
 			[this](ServerMethod& method, ofxOscMessage& inMessage, Server& server)
 			{
@@ -51,15 +93,59 @@ Server::Server()
 							<< "Tried to set parameter but OSC Message did not have the right number of arguments.";
 					return;
 				}
-				ParameterData pd;
-				pd.parameterPath = inMessage.getArgAsString(0);
-				pd.parameterValue = inMessage.getArgAsString(1);
-				parameterThreadChannel.send(std::move(pd));
-//				setParameter(inMessage.getArgAsString(0), inMessage.getArgAsString(1));
+				queueParameter(inMessage.getArgAsString(0), inMessage.getArgAsString(1));
+			}));
+
+	addServerMethod(ServerMethod(
+			MethodSetById,
+			"Set parameter by id",
+			{{"modelKey", "The modelKey attribute of the model that the id comes from", "int"},
+			 {"id", "The id of the parameter in the model", "int"},
+			 {"value", "The value of the parameter", "string"}},
+			[this](ServerMethod& method, const MethodArguments& arguments, Server& server)
+			{
+				queueParameterById(arguments.get<int32_t>(0), arguments.get<int32_t>(1),
+								   arguments.get<std::string>(2));
+			}));
+
+	addServerMethod(ServerMethod(
+			MethodSetRange,
+			"Set range",
+			{{"path", "Path of the array parameter", "string"},
+			 {"offset", "Index of the first element to overwrite", "int"},
+			 {"values", "The elements, as 32 bit values", "blob"}},
+			[this](ServerMethod& method, const MethodArguments& arguments, Server& server)
+			{
+				applyingRemoteValues = true;
+				applyRange(arguments.get<std::string>(0), arguments.get<int32_t>(1), arguments.get<ofBuffer>(2));
+				applyingRemoteValues = false;
+			}));
+
+	addServerMethod(ServerMethod(
+			MethodGetValues,
+			"Get values",
+			{{"path", "Path of the subtree, empty for all the parameters", "string", "", true}},
+			[this](ServerMethod& method, const MethodArguments& arguments, Server& server)
+			{
+				ofxOscMessage outMessage;
+				if (!serializeValues(arguments.get<std::string>(0), outMessage)) return;
+				server.sendReply(method, outMessage);
 			}));
 
 	addServerMethod(ServerMethod(
-			"close",
+			MethodGetTrace,
+			"Get trace",
+			// By default, the most recent spans that fit in a UDP packet:
+			{{"maxSpans", "The number of spans, 0 for all of them", "int", "400", true}},
+			[this](ServerMethod& method, const MethodArguments& arguments, Server& server)
+			{
+				ofxOscMessage outMessage;
+				outMessage.addStringArg(Tracing::toChromeTraceJson(std::max(0, arguments.get<int32_t>(0))));
+				server.sendReply(method, outMessage);
+			}));
+
+	addServerMethod(ServerMethod(
+			MethodClose,
 			"Close server",
 			[this](ServerMethod& method, ofxOscMessage& inMessage, Server& server)
 			{
@@ -70,23 +156,10 @@ Server::Server()
 
 	// We can add here any value that OF has an ofToString for.
 	// Any other types you'll need to add externally
-	addParameterType<int>("int", true);
-	addParameterType<float>("float", true);
-	addParameterType<double>("double", true);
-	addParameterType<ofColor>("color");
-	addParameterType<ofFloatColor>("floatColor");
-	addParameterType<ofParameterGroup>("group");
-	addParameterType<std::string>("string");
-	addParameterType<bool>("boolean");
-	addParameterType<glm::vec2>("vec2", true);
-	addParameterType<glm::vec3>("vec3", true);
-	addParameterType<glm::vec4>("vec4", true);
-	addParameterType<ofRectangle>("ofRectangle");
-	addParameterType<ofQuaternion>("ofQuaternion");
-	addParameterType<ofMatrix3x3>("ofMatrix3x3");
-	addParameterType<ofMatrix4x4>("ofMatrix4x4");
-
-	// Add ofParameterGroup "manually" because we don't want it boxed into an ofParameter:
+	addParameterTypes<BuiltinTypes>();
+
+	// Add ofParameterGroup "manually" because we don't want it boxed into an ofParameter.
+	// Its typeId stays CustomTypeId, so it is never dispatched as an ofParameter<ofParameterGroup>:
 	TypeInfo paramInfo;
 	paramInfo.name = "group";
 	paramInfo.hasLimits = false;
@@ -106,6 +179,9 @@ void Server::setup(ofParameterGroup& parameters,
 				   int outPort)
 {
 	group = std::make_shared<ofParameterGroup>(parameters);
+	parameterTableValid = false;
+	namespaces.clear();
+	hostsGroups = false;
 	if (group->getName().empty())
 	{
 		group->setName("ofxRemoteParameters");
@@ -113,6 +189,7 @@ void Server::setup(ofParameterGroup& parameters,
 	oscReceiver.setup(inPort);
 	this->inPort = inPort;
 	this->outPort = outPort;
+	updateValueListener();
 
 	// Todo:
 	// Add a listener to all parameters so that when any of them updates we
@@ -124,124 +201,987 @@ void Server::setup(ofParameterGroup& parameters,
 	setAutoUpdate(true);
 }
 
-void Server::close()
+void Server::setup(const std::string& name, int inPort, int outPort)
+{
+	ofParameterGroup root;
+	root.setName(name);
+	setup(root, inPort, outPort);
+	hostsGroups = true;
+}
+
+bool Server::addGroup(ofParameterGroup& parameters)
+{
+	if (!hostsGroups)
+	{
+		ofLogError(ModuleName) << "addGroup: the Server must be set up with a name to host several groups";
+		return false;
+	}
+	auto name = parameters.getEscapedName();
+	if (name.empty() || name == group->getEscapedName() || namespaces.count(name) > 0)
+	{
+		ofLogError(ModuleName) << "addGroup: a group needs a name that is not already hosted, \"" << name
+							   << "\" can't be added";
+		return false;
+	}
+	group->add(parameters);
+	namespaces.emplace(name, std::make_shared<ofParameterGroup>(parameters));
+	parameterTableValid = false;
+	// Even with no Client connected, the ids of the previous model are stale and the observers need the new one:
+	syncParameters();
+	return true;
+}
+
+void Server::close()
+{
+	oscReceiver.stop();
+	oscSender.clear();
+	loopListener.reset();
+	hasClient = false;
+	if (multicast) stopMulticast();
+}
+
+void Server::setAutoUpdate(bool autoUpdate)
+{
+	if (autoUpdate)
+	{
+		loopListener = ofGetMainLoop()->loopEvent.newListener([this]()
+															  {
+																  update();
+															  });
+	}
+	else
+	{
+		loopListener.reset();
+	}
+}
+
+void Server::setPacing(uint64_t bytesPerSecond, std::size_t burstBytes, std::size_t maxQueuedBytes)
+{
+	oscSender.setPacing(bytesPerSecond, burstBytes, maxQueuedBytes);
+	multicastSender.setPacing(bytesPerSecond, burstBytes, maxQueuedBytes);
+}
+
+void Server::setFrameBudget(uint64_t budgetMicros)
+{
+	frameBudgetMicros = budgetMicros;
+}
+
+uint64_t Server::getFrameBudget() const
+{
+	return frameBudgetMicros;
+}
+
+const Server::Stats& Server::getStats() const
+{
+	return stats;
+}
+
+void Server::update()
+{
+	OFXRP_TRACE_SCOPE("Server::update");
+	auto updateStart = ofGetElapsedTimeMicros();
+	auto deadline = frameBudgetMicros > 0 ? updateStart + frameBudgetMicros : std::numeric_limits<uint64_t>::max();
+	static const std::string setAddress = ApiRoot + "/" + MethodSetParam;
+	static const std::string setByIdAddress = ApiRoot + "/" + MethodSetById;
+	static const std::string heartbeatAddress = ApiRoot + "/" + MethodHeartbeat;
+	static const std::string setRangeAddress = ApiRoot + "/" + MethodSetRange;
+	static const std::string reliablePrefix = ApiReliable + "/";
+	oscSender.drain();
+	if (multicast) multicastSender.drain();
+	if (transactionMode) beginTransaction();
+
+	oscReceiver.receive(receivedMessages);
+	for (auto& entry : receivedMessages)
+	{
+		if (entry->isSet)
+		{
+			if (recorder.isOpen())
+			{
+				ofxOscMessage setMessage;
+				if (entry->id >= 0 && isCurrentModelId(entry->modelKey, entry->id))
+				{
+					// Ids are only valid for this model, so the log gets the path, which a replay can resolve later:
+					parameterTable.getPath(parameterTable.getValueEntry(entry->id), tablePath);
+					setMessage.setAddress(setAddress);
+					setMessage.addStringArg(tablePath);
+				}
+				else if (entry->id >= 0)
+				{
+					setMessage.setAddress(setByIdAddress);
+					setMessage.addInt32Arg(entry->modelKey);
+					setMessage.addInt32Arg(entry->id);
+				}
+				else
+				{
+					setMessage.setAddress(setAddress);
+					setMessage.addStringArg(entry->path);
+				}
+				setMessage.addStringArg(entry->value);
+				recorder.record(setMessage, ofGetElapsedTimeMicros() - recordingStartMicros);
+			}
+			if (entry->id >= 0)
+			{
+				queueParameterById(entry->modelKey, entry->id, entry->value);
+			}
+			else
+			{
+				queueParameter(entry->path, entry->value);
+			}
+			continue;
+		}
+		auto& inMsg = entry->message;
+		// Unwrapped before recording, so that replays don't execute the duplicates:
+		if (inMsg.getAddress().compare(0, reliablePrefix.size(), reliablePrefix) == 0 && !receiveReliable(inMsg))
+		{
+			continue;
+		}
+		if (recorder.isOpen())
+		{
+			recorder.record(inMsg, ofGetElapsedTimeMicros() - recordingStartMicros);
+		}
+		if (inMsg.getAddress() == setAddress || inMsg.getAddress() == setByIdAddress ||
+			inMsg.getAddress() == heartbeatAddress)
+		{
+			// Cheap: set only queues the value for applyPendingParameters(). Heartbeats are answered right away so
+			// that a busy frame doesn't make the Client think that the connection was lost.
+			parseMessage(inMsg);
+		}
+		else if (inMsg.getAddress() == setRangeAddress)
+		{
+			// Ranges are applied right away, after the values that were received before them
+			applyPendingParameters();
+			parseMessage(inMsg);
+		}
+		else
+		{
+			pendingMethodCalls.push_back(std::move(inMsg));
+		}
+	}
+	oscReceiver.recycle(receivedMessages);
+
+	if (replayer.isOpen())
+	{
+		replayPendingMessages();
+	}
+
+	// Lane 1: parameter sets. These are always applied in full, since they are coalesced per path.
+	applyPendingParameters();
+	applyQueuedWrites();
+	if (transactionMode) endTransaction();
+
+	// Lane 2: method calls, at least one per frame so that they can't be starved by parameter traffic.
+	while (!pendingMethodCalls.empty())
+	{
+		auto message = std::move(pendingMethodCalls.front());
+		pendingMethodCalls.pop_front();
+		parseMessage(message);
+		if (ofGetElapsedTimeMicros() >= deadline) break;
+	}
+
+	// Lane 3: model serialization, time-sliced over as many frames as it needs.
+	if (modelJob.active)
+	{
+		if (serializeModelStep(deadline))
+		{
+			finishModelSerialization();
+		}
+	}
+
+	if (multicast && ofGetElapsedTimeMillis() - lastAnnounceMillis >= announceIntervalMillis)
+	{
+		lastAnnounceMillis = ofGetElapsedTimeMillis();
+		// A change in the structure of the parameters since the last announce starts a new revision:
+		if (announcedModelValid && !modelJob.active) refreshParameterTable();
+		if (announcedModelValid && announcedModelRevision == modelRevision)
+		{
+			announceModel(announcedModel);
+		}
+		else if (frameBudgetMicros > 0)
+		{
+			if (!modelJob.active) startModelSerialization();
+			modelJob.announce = true;
+		}
+		else
+		{
+			auto model = createMetaModel();
+			stats.serializedAnnouncements++;
+			cacheAnnouncedModel(std::move(model), modelJob.revision);
+			announceModel(announcedModel);
+		}
+	}
+
+	if ((valuePush && hasClient) || multicast)
+	{
+		updateFilters.flush(ofGetElapsedTimeMicros(), [this](const std::string& path, const std::string& value)
+		{
+			sendValue(path, value);
+		});
+	}
+
+	stats.pendingMethodCalls = pendingMethodCalls.size();
+	stats.pendingModelRequests = modelJob.active ? modelJob.pendingRequests : 0;
+	stats.modelSerializationProgress = modelJob.active && modelJob.parameterCount > 0
+									   ? float(modelJob.parametersWritten) / modelJob.parameterCount
+									   : 0;
+	stats.queuedPackets = oscSender.getQueuedPackets() + multicastSender.getQueuedPackets();
+	stats.queuedBytes = oscSender.getQueuedBytes() + multicastSender.getQueuedBytes();
+	stats.droppedPackets = oscSender.getDroppedPackets() + multicastSender.getDroppedPackets();
+	stats.lastUpdateMicros = ofGetElapsedTimeMicros() - updateStart;
+	if (frameBudgetMicros > 0 && stats.lastUpdateMicros > frameBudgetMicros)
+	{
+		stats.budgetOverruns++;
+	}
+}
+
+void Server::queueParameter(const std::string& path, const std::string& value)
+{
+	queueValue(findPendingSlot(path), value);
+}
+
+bool Server::isCurrentModelId(int32_t modelKey, int32_t id)
+{
+	ensureParameterTable();
+	if (modelKey != this->modelKey || id < 0 || static_cast<std::size_t>(id) >= parameterTable.getValueCount())
+	{
+		return false;
+	}
+	if (parameterTable.isAttached(parameterTable.getValueEntry(id))) return true;
+	// The parameters were restructured without a sync. Rebuilding the table starts a new revision, in which the ids
+	// of the Client are stale.
+	parameterTableValid = false;
+	ensureParameterTable();
+	return false;
+}
+
+void Server::queueParameterById(int32_t modelKey, int32_t id, const std::string& value)
+{
+	if (!isCurrentModelId(modelKey, id))
+	{
+		ofLogWarning(ModuleName) << "setById: " << id << " is not a parameter id of the current model, the value is "
+								 << "dropped";
+		return;
+	}
+	if (idSlots[id] == NoSlot)
+	{
+		parameterTable.getPath(parameterTable.getValueEntry(id), tablePath);
+		auto slot = findPendingSlot(tablePath);
+		idSlots[id] = slot;
+		pendingValues[slot].id = id;
+	}
+	queueValue(idSlots[id], value);
+}
+
+std::size_t Server::findPendingSlot(const std::string& path)
+{
+	auto slot = pendingValueSlots.find(path);
+	if (slot != pendingValueSlots.end()) return slot->second;
+
+	if (pendingValueSlots.size() >= MaxPendingValueSlots && pendingValueOrder.empty())
+	{
+		pendingValueSlots.clear();
+		pendingValues.clear();
+		std::fill(idSlots.begin(), idSlots.end(), NoSlot);
+	}
+	pendingValueSlots.emplace(path, pendingValues.size());
+	pendingValues.emplace_back();
+	pendingValues.back().path = path;
+	return pendingValues.size() - 1;
+}
+
+void Server::queueValue(std::size_t slot, const std::string& value)
+{
+	auto& pending = pendingValues[slot];
+	pending.value = value;
+	if (!pending.isPending)
+	{
+		pending.isPending = true;
+		pendingValueOrder.push_back(slot);
+	}
+}
+
+void Server::applyPendingParameters()
+{
+	OFXRP_TRACE_SCOPE("Server::applyPendingParameters");
+	// Only the last value received for a path is applied... otherwise things get way too spammy
+	applyingRemoteValues = true;
+	for (auto index : pendingValueOrder)
+	{
+		auto& pending = pendingValues[index];
+		pending.isPending = false;
+		if (pending.id < 0)
+		{
+			applyParameter(pending.path, pending.value);
+		}
+		else if (!customHandlers.route(pending.path, pending.value))
+		{
+			auto& entry = parameterTable.getValue(pending.id);
+			deserializeParameter(*entry.parameter, entry.typeId, pending.value);
+		}
+	}
+	pendingValueOrder.clear();
+	applyingRemoteValues = false;
+}
+
+void Server::setValuePush(bool enabled)
+{
+	valuePush = enabled;
+	updateValueListener();
+}
+
+void Server::updateValueListener()
+{
+	valuePushListener.unsubscribe();
+	if ((valuePush || multicast) && group)
+	{
+		valuePushListener = group->parameterChangedE().newListener([this](ofAbstractParameter& parameter)
+		{
+			pushParameter(parameter);
+		});
+	}
+}
+
+bool Server::getValuePush() const
+{
+	return valuePush;
+}
+
+bool Server::startMulticast(const std::string& groupAddress, int port, uint64_t announceIntervalMillis)
+{
+	if (!multicastSender.setup(groupAddress, port))
+	{
+		ofLogError(ModuleName) << "Could not set up multicast to " << groupAddress << ":" << port;
+		multicast = false;
+		return false;
+	}
+	multicast = true;
+	announcedModelValid = false;
+	this->announceIntervalMillis = announceIntervalMillis;
+	// Announce the model on the next update():
+	lastAnnounceMillis = ofGetElapsedTimeMillis() - announceIntervalMillis;
+	updateValueListener();
+	return true;
+}
+
+void Server::stopMulticast()
+{
+	multicast = false;
+	multicastSender.clear();
+	updateValueListener();
+}
+
+bool Server::isMulticasting() const
+{
+	return multicast;
+}
+
+void Server::announceModel(const std::string& model)
+{
+	// Observers can't ask for compression, so the model is announced as text:
+	ofxOscMessage message;
+	message.setAddress(ApiResponse + "/" + MethodGetModel);
+	message.addStringArg(model);
+	message.addStringArg(getModelIdentity());
+	multicastSender.sendMessage(message);
+	stats.modelAnnouncements++;
+}
+
+void Server::setUpdateFilter(const std::string& pathPattern, const UpdateFilter& filter)
+{
+	updateFilters.setPathFilter(pathPattern, filter);
+}
+
+void Server::pushParameter(ofAbstractParameter& parameter)
+{
+	OFXRP_TRACE_SCOPE("Server::pushParameter");
+	// The observers that join later must get the new value with the model:
+	announcedModelValid = false;
+	auto path = getParameterPath(parameter);
+	// Values set by the Client are only published to the observers:
+	bool toClient = !applyingRemoteValues;
+	if (applyingRemoteValues)
+	{
+		// The Client already has this value, so the next change has to be compared against it:
+		updateFilters.forget(path);
+	}
+	if (!(toClient && valuePush && hasClient) && !multicast) return;
+
+	auto typeIter = typeRegistry.find(std::type_index(typeid(parameter)));
+	if (typeIter == typeRegistry.end()) return;
+	auto& typeInfo = typeIter->second;
+
+	bool isArray = false;
+	dispatchBuiltinType(typeInfo.typeId, [&](auto tag)
+	{
+		using ParameterType = typename decltype(tag)::type;
+		if constexpr (ArrayTraits<ParameterType>::isArray)
+		{
+			isArray = true;
+			pushArray(path, static_cast<ofParameter<ParameterType>&>(parameter).get(), toClient);
+		}
+	});
+	if (isArray) return;
+
+	auto filter = updateFilters.findPathFilter(path);
+	if (!filter && typeInfo.updateFilter.isActive()) filter = &typeInfo.updateFilter;
+	// Values set by the Client have already been filtered by it:
+	if (!filter || !toClient)
+	{
+		sendValue(path, parameter.toString(), toClient);
+		return;
+	}
+
+	auto now = ofGetElapsedTimeMicros();
+	std::string value;
+	bool isSignificant = false;
+	bool isBuiltin = dispatchBuiltinType(typeInfo.typeId, [&](auto tag)
+	{
+		using ParameterType = typename decltype(tag)::type;
+		auto& typedParameter = static_cast<ofParameter<ParameterType>&>(parameter);
+		isSignificant = updateFilters.filterValue(path, *filter, typedParameter.get(), value, now);
+	});
+	if (!isBuiltin)
+	{
+		value = parameter.toString();
+		isSignificant = updateFilters.filterString(path, *filter, value, now);
+	}
+	if (isSignificant) sendValue(path, value);
+}
+
+void Server::sendValue(const std::string& path, const std::string& value, bool toClient)
+{
+	static const std::string address = ApiResponse + "/" + MethodSetParam;
+	updateWriter.begin(address).addString(path).addString(value);
+	sendUpdate(toClient);
+}
+
+void Server::sendRange(const std::string& path, std::size_t offset, const ofBuffer& values, bool toClient)
+{
+	static const std::string address = ApiResponse + "/" + MethodSetRange;
+	updateWriter.begin(address).addString(path).addInt32(static_cast<int32_t>(offset));
+	updateWriter.addBlob(values.getData(), values.size());
+	sendUpdate(toClient);
+}
+
+void Server::sendUpdate(bool toClient)
+{
+	if (toClient && valuePush && hasClient) oscSender.send(updateWriter);
+	if (multicast) multicastSender.send(updateWriter);
+}
+
+void Server::applyRange(const std::string& path, int32_t offset, const ofBuffer& values)
+{
+	auto parameter = findParameter(path);
+	if (!parameter || offset < 0)
+	{
+		ofLogError(ModuleName) << "setRange: couldn't find parameter " << path << " or the offset is negative";
+		return;
+	}
+
+	bool isApplied = false;
+	auto typeIter = typeRegistry.find(std::type_index(typeid(*parameter)));
+	if (typeIter != typeRegistry.end())
+	{
+		dispatchBuiltinType(typeIter->second.typeId, [&](auto tag)
+		{
+			using ParameterType = typename decltype(tag)::type;
+			if constexpr (ArrayTraits<ParameterType>::isArray)
+			{
+				std::vector<typename ArrayTraits<ParameterType>::ElementType> elements;
+				if (!arrayFromBlob(values, elements)) return;
+				isApplied = true;
+				auto& typedParameter = static_cast<ofParameter<ParameterType>&>(*parameter);
+				auto& current = typedParameter.get();
+				bool isChanged = offset + elements.size() > current.size() ||
+								 !std::equal(elements.begin(), elements.end(), current.begin() + offset);
+				// In a transaction, the listeners are only told about the change at the end, like for set:
+				if (!writeRange(typedParameter, offset, elements.data(), elements.size(), !inTransaction))
+				{
+					ofLogError(ModuleName) << "setRange: offset " << offset << " is past the end of " << path;
+				}
+				else if (inTransaction && isChanged)
+				{
+					transactionChanges.emplace_back(parameter.get(), applyingRemoteValues);
+				}
+			}
+		});
+	}
+	if (!isApplied)
+	{
+		ofLogError(ModuleName) << "setRange: " << path << " is not an array parameter, or the blob size doesn't match"
+							   << " its element type";
+	}
+}
+
+std::string Server::getParameterPath(const ofAbstractParameter& parameter) const
+{
+	auto names = parameter.getGroupHierarchyNames();
+	std::size_t index = 0;
+	std::string path;
+	if (namespaces.empty())
+	{
+		index = ofFind(names, group->getEscapedName());
+	}
+	else
+	{
+		// A hosted group may belong to groups of the app as well, whose names come first in the hierarchy
+		while (index < names.size() && namespaces.count(names[index]) == 0) index++;
+		if (index == names.size()) return path;
+		path = "/" + group->getEscapedName();
+	}
+	for (std::size_t i = index; i < names.size(); i++)
+	{
+		path += "/" + names[i];
+	}
+	return path;
+}
+
+std::string Server::createMetaModel()
+{
+	OFXRP_TRACE_SCOPE("Server::createMetaModel");
+	startModelSerialization();
+	if (serializationThreads > 1 && modelJob.parameterCount >= ParallelSerializationMinimum)
+	{
+		serializeModelParallel();
+	}
+	else
+	{
+		serializeModelStep(std::numeric_limits<uint64_t>::max());
+	}
+	modelJob.active = false;
+	return std::move(modelJob.writer.getString());
+}
+
+void Server::startModelSerialization()
+{
+	// getValues and the ids follow the order of the last model that was sent:
+	modelJob.active = false;
+	refreshParameterTable();
+	modelJob.writer.clear();
+	modelJob.openGroups.clear();
+	modelJob.parametersWritten = 0;
+	modelJob.parameterCount = parameterTable.size() - 1;
+	modelJob.revision = modelRevision;
+	modelJob.pendingRequests = 0;
+	modelJob.announce = false;
+	modelJob.compress = false;
+	modelJob.active = true;
+
+	modelJob.writer.openElement("ofxRemoteParameters");
+	modelJob.writer.openElement("Parameters");
+	openParameterGroup(parameterTable[0], modelJob.writer);
+	modelJob.writer.attribute(AttributeName_ModelKey, ofToString(modelKey));
+	modelJob.openGroups.push_back(0);
+	modelJob.nextEntry = 1;
+}
+
+bool Server::serializeModelStep(uint64_t deadlineMicros)
+{
+	OFXRP_TRACE_SCOPE("Server::serializeModelStep");
+	// Checking the clock for every parameter would cost more than serializing most of them:
+	const std::size_t parametersPerClockCheck = 32;
+	std::size_t sinceClockCheck = 0;
+
+	while (modelJob.nextEntry < parameterTable.size())
+	{
+		auto index = modelJob.nextEntry++;
+		auto& entry = parameterTable[index];
+		// The groups that the previous entries were in are closed once their subtree is done:
+		while (modelJob.openGroups.back() != entry.parent)
+		{
+			modelJob.writer.closeElement();
+			modelJob.openGroups.pop_back();
+		}
+		modelJob.parametersWritten++;
+		if (entry.isGroup)
+		{
+			openParameterGroup(entry, modelJob.writer);
+			modelJob.openGroups.push_back(index);
+		}
+		else
+		{
+			serializeParameter(index, modelJob.writer);
+		}
+
+		if (++sinceClockCheck == parametersPerClockCheck)
+		{
+			sinceClockCheck = 0;
+			if (ofGetElapsedTimeMicros() >= deadlineMicros) return false;
+		}
+	}
+
+	for (; !modelJob.openGroups.empty(); modelJob.openGroups.pop_back())
+	{
+		modelJob.writer.closeElement();
+	}
+	finishModelDocument(modelJob.writer);
+	return true;
+}
+
+void Server::finishModelDocument(XmlWriter& writer)
+{
+	writer.closeElement(); // Parameters
+	writer.openElement("Methods");
+	serializeMethods(writer);
+	writer.closeElement();
+	writer.closeElement(); // ofxRemoteParameters
+}
+
+void Server::setSerializationThreads(std::size_t threads)
+{
+	serializationThreads = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+	serializationPool.start(serializationThreads - 1);
+}
+
+std::size_t Server::getSerializationThreads() const
+{
+	return serializationThreads;
+}
+
+void Server::serializeModelParallel()
+{
+	OFXRP_TRACE_SCOPE("Server::serializeModelParallel");
+	// startModelSerialization() has opened the root group; its contents are written here instead of by the step:
+	modelJob.openGroups.clear();
+	std::vector<SerializationStep> plan;
+	std::vector<SerializationTask> tasks;
+	// Several tasks per thread, so that threads that finish early can pick up the remaining ones:
+	auto taskSize = std::max<std::size_t>(1, modelJob.parameterCount / (serializationThreads * 4));
+	planSerialization(0, modelJob.writer.getDepth(), taskSize, plan, tasks);
+
+	std::vector<std::string> fragments(tasks.size());
+	std::atomic<std::size_t> nextTask(0);
+	auto work = [&]()
+	{
+		for (auto i = nextTask++; i < tasks.size(); i = nextTask++)
+		{
+			OFXRP_TRACE_SCOPE("Server::serializeFragment");
+			auto& task = tasks[i];
+			XmlWriter writer;
+			writer.setBaseDepth(task.depth);
+			serializeEntries(task.begin, task.end, writer);
+			fragments[i] = std::move(writer.getString());
+		}
+	};
+	serializationPool.run(work);
+
+	// Stitch the fragments together in model order:
+	for (auto& step : plan)
+	{
+		if (step.group != ParameterTable::NoEntry)
+		{
+			openParameterGroup(parameterTable[step.group], modelJob.writer);
+		}
+		else if (step.task == SerializationStep::CloseGroup)
+		{
+			modelJob.writer.closeElement();
+		}
+		else
+		{
+			modelJob.writer.appendFragment(fragments[step.task]);
+		}
+	}
+	modelJob.writer.closeElement(); // The root group
+	modelJob.nextEntry = static_cast<ParameterTable::Index>(parameterTable.size());
+	modelJob.parametersWritten = modelJob.parameterCount;
+	finishModelDocument(modelJob.writer);
+}
+
+void Server::planSerialization(ParameterTable::Index parent,
+							   std::size_t depth,
+							   std::size_t taskSize,
+							   std::vector<SerializationStep>& plan,
+							   std::vector<SerializationTask>& tasks)
+{
+	auto runBegin = parent + 1;
+	std::size_t runWeight = 0;
+	auto addTask = [&](ParameterTable::Index end)
+	{
+		if (end == runBegin) return;
+		plan.push_back({ParameterTable::NoEntry, tasks.size()});
+		tasks.push_back({runBegin, end, depth});
+		runBegin = end;
+		runWeight = 0;
+	};
+
+	// The children of parent follow it, and each one is followed by its subtree:
+	auto parentEnd = parameterTable[parent].subtreeEnd;
+	for (auto child = parent + 1; child < parentEnd; child = parameterTable[child].subtreeEnd)
+	{
+		auto& entry = parameterTable[child];
+		std::size_t weight = entry.subtreeEnd - child;
+		if (entry.isGroup && weight > taskSize)
+		{
+			// Too large for one task: its children are split into tasks instead
+			addTask(child);
+			plan.push_back({child, 0});
+			planSerialization(child, depth + 1, taskSize, plan, tasks);
+			plan.push_back({ParameterTable::NoEntry, SerializationStep::CloseGroup});
+			runBegin = entry.subtreeEnd;
+			continue;
+		}
+		runWeight += weight;
+		if (runWeight >= taskSize) addTask(entry.subtreeEnd);
+	}
+	addTask(parentEnd);
+}
+
+void Server::serializeEntries(ParameterTable::Index begin, ParameterTable::Index end, XmlWriter& writer)
+{
+	std::vector<ParameterTable::Index> openGroups;
+	for (auto index = begin; index < end; index++)
+	{
+		auto& entry = parameterTable[index];
+		while (!openGroups.empty() && openGroups.back() != entry.parent)
+		{
+			writer.closeElement();
+			openGroups.pop_back();
+		}
+		if (entry.isGroup)
+		{
+			openParameterGroup(entry, writer);
+			openGroups.push_back(index);
+		}
+		else
+		{
+			serializeParameter(index, writer);
+		}
+	}
+	for (; !openGroups.empty(); openGroups.pop_back())
+	{
+		writer.closeElement();
+	}
+}
+
+void Server::finishModelSerialization()
+{
+	modelJob.active = false;
+	if (modelJob.pendingRequests > 0)
+	{
+		ofxOscMessage outMessage;
+		addModelArgument(outMessage, modelJob.writer.getString(), modelJob.compress);
+		outMessage.addStringArg(getModelIdentity());
+		sendReply(serverMethods.at(MethodGetModel), outMessage);
+	}
+	if (modelJob.announce && multicast)
+	{
+		stats.serializedAnnouncements++;
+		cacheAnnouncedModel(modelJob.writer.getString(), modelJob.revision);
+		announceModel(announcedModel);
+	}
+}
+
+void Server::cacheAnnouncedModel(std::string model, uint32_t revision)
 {
-	oscReceiver.stop();
-	oscSender.clear();
-	loopListener.reset();
+	announcedModel = std::move(model);
+	announcedModelRevision = revision;
+	announcedModelValid = true;
 }
 
-void Server::setAutoUpdate(bool autoUpdate)
+bool Server::serializeValues(const std::string& subtreePath, ofxOscMessage& message)
 {
-	if (autoUpdate)
+	// The values of a whole subtree are read from the table, so all of it is checked against the groups:
+	if (modelJob.active) ensureParameterTable();
+	else refreshParameterTable();
+
+	std::string path = subtreePath;
+	while (!path.empty() && path.back() == '/') path.pop_back();
+	if (path.empty()) path = "/" + parameterTable.getEscapedName(parameterTable[0]);
+	auto index = parameterTable.find(path);
+	if (index == ParameterTable::NoEntry)
 	{
-		loopListener = ofGetMainLoop()->loopEvent.newListener([this]()
-															  {
-																  update();
-															  });
+		ofLogError(ModuleName) << "getValues: couldn't find " << subtreePath;
+		return false;
 	}
-	else
+
+	message.addStringArg(getModelIdentity());
+	message.addStringArg(path);
+	auto& subtree = parameterTable[index];
+	for (auto id = subtree.valueBegin; id < subtree.valueEnd; id++)
 	{
-		loopListener.reset();
+		auto& entry = parameterTable.getValue(id);
+		std::string value;
+		bool isBuiltin = dispatchBuiltinType(entry.typeId, [&](auto tag)
+		{
+			using ParameterType = typename decltype(tag)::type;
+			value = valueToString(static_cast<ofParameter<ParameterType>&>(*entry.parameter).get());
+		});
+		if (!isBuiltin) value = entry.parameter->toString();
+		message.addStringArg(value);
 	}
+	return true;
 }
 
-void Server::update()
+ParameterTable::Index Server::findTableEntry(const std::string& path)
+{
+	ensureParameterTable();
+	auto index = parameterTable.find(path);
+	if (index == ParameterTable::NoEntry || parameterTable.isAttached(index)) return index;
+	// The parameters were restructured without a sync, and the path led to a detached parameter:
+	parameterTableValid = false;
+	ensureParameterTable();
+	return parameterTableValid ? parameterTable.find(path) : ParameterTable::NoEntry;
+}
+
+void Server::ensureParameterTable()
+{
+	// A model serialized over several frames is written from the table, which must stay as it is until the end
+	if (parameterTableValid || modelJob.active) return;
+	refreshParameterTable();
+}
+
+void Server::refreshParameterTable()
 {
-	while (oscReceiver.hasWaitingMessages())
+	auto resolveType = [this](const ofAbstractParameter& parameter, TypeId& typeId)
 	{
-		ofxOscMessage inMsg;
-		oscReceiver.getNextMessage(inMsg);
-		parseMessage(inMsg);
+		// serializeParameter() skips the unregistered types, so they don't get an id either
+		auto typeIter = typeRegistry.find(std::type_index(typeid(parameter)));
+		if (typeIter == typeRegistry.end()) return false;
+		typeId = typeIter->second.typeId;
+		return true;
+	};
+	if (parameterTable.size() > 0)
+	{
+		if (parameterTable.matches(group, resolveType))
+		{
+			// Same parameters, same ids: the table and the slots of the ids can be kept
+			parameterTableValid = true;
+			return;
+		}
+		// The ids change with the structure, so the ids of the previous table must be rejected from now on. There is
+		// no need for another revision if there has been one since the table was built, e.g. by syncParameters().
+		if (modelRevision == parameterTableRevision) setModelRevision(modelRevision + 1);
+	}
+	parameterTableRevision = modelRevision;
+	parameterTable.build(group, resolveType);
+	idSlots.assign(parameterTable.getValueCount(), NoSlot);
+	for (auto& pending : pendingValues)
+	{
+		pending.id = -1;
 	}
+	stats.parameterTableBytes = parameterTable.getMemoryBytes();
+	parameterTableValid = true;
+}
 
-	std::unordered_map<std::string, std::string> pDataMap;
-	ParameterData parameterData;
-	while (parameterThreadChannel.tryReceive(parameterData))
+void Server::addModelArgument(ofxOscMessage& message, const std::string& model, bool compress)
+{
+	stats.lastModelBytes = model.size();
+	if (!compress || !modelCompression || model.size() < compressionMinimumBytes)
 	{
-		pDataMap[parameterData.parameterPath] = parameterData.parameterValue;
+		message.addStringArg(model);
+		return;
 	}
-	// Only send the last received data for a given path... otherwise things get way too spammy
-	for (auto& pair : pDataMap)
+
+	auto start = ofGetElapsedTimeMicros();
+	ofBuffer compressed;
+	if (!ModelCompression::compress(model, compressed))
 	{
-		setParameter(pair.first, pair.second);
+		ofLogWarning(ModuleName) << "Could not compress the model, sending it uncompressed";
+		message.addStringArg(model);
+		return;
 	}
+	stats.lastCompressionMicros = ofGetElapsedTimeMicros() - start;
+	stats.lastCompressedModelBytes = compressed.size();
+	stats.lastCompressionRatio = compressed.size() > 0 ? static_cast<float>(model.size()) / compressed.size() : 0;
+	message.addBlobArg(compressed);
 }
 
-ofXml Server::createMetaModel()
+void Server::setModelCompression(bool enabled, std::size_t minimumBytes)
 {
-	ofXml xml;
-	auto root = xml.appendChild("ofxRemoteParameters");
-	auto paramsXml = root.appendChild("Parameters");
-	serializeParameterGroup(group, paramsXml);
-	auto methodsXml = root.appendChild("Methods");
-	serializeMethods(methodsXml);
-	return xml;
+	modelCompression = enabled;
+	compressionMinimumBytes = minimumBytes;
 }
 
-void Server::serializeMethods(ofXml& xml)
+void Server::serializeMethods(XmlWriter& writer)
 {
 	for (auto& pair : serverMethods)
 	{
-		xml.appendChild(pair.second.getIdentifier())
-		   .setAttribute(AttributeName_UiName, pair.second.getUiName());
+		writer.openElement(pair.second.getIdentifier());
+		writer.attribute(AttributeName_UiName, pair.second.getUiName());
+		for (auto& argument : pair.second.getArguments())
+		{
+			writer.openElement(NodeName_Argument);
+			writer.attribute(AttributeName_Name, argument.identifier);
+			writer.attribute(AttributeName_Type, argument.type);
+			if (!argument.info.empty()) writer.attribute(AttributeName_Info, argument.info);
+			if (argument.isOptional) writer.attribute(AttributeName_Default, argument.value);
+			writer.closeElement();
+		}
+		writer.closeElement();
 	}
 }
 
-void Server::serializeParameterGroup(std::shared_ptr<ofParameterGroup> params, ofXml& xml)
+void Server::openParameterGroup(const ParameterTable::Entry& entry, XmlWriter& writer)
 {
-	auto groupXml = xml.appendChild(params->getEscapedName());
-	groupXml.appendAttribute(AttributeName_Type).set("group"); // TODO: type string constants?
-	groupXml.appendAttribute(AttributeName_Name).set(params->getName());
-	for (auto& param : *params)
-	{
-		serializeParameter(param, groupXml);
-	}
+	writer.openElement(parameterTable.getEscapedName(entry));
+	writer.attribute(AttributeName_Type, "group"); // TODO: type string constants?
+	writer.attribute(AttributeName_Name, parameterTable.getName(entry));
 }
 
-void Server::serializeParameter(std::shared_ptr<ofAbstractParameter> parameter, ofXml& xml)
+void Server::serializeParameter(ParameterTable::Index index, XmlWriter& writer)
 {
-	TypeInfo typeInfo;
-	std::string min = "";
-	std::string max = "";
-
-	try
-	{
-		typeInfo = typeRegistry.at(std::type_index(typeid(*parameter)));
-	}
-	catch (std::out_of_range e)
+	auto& entry = parameterTable[index];
+	auto& parameter = entry.parameter;
+	if (!entry.isRegistered)
 	{
 		ofLogNotice(ModuleName) << "Tried adding parameter of unknown type: "
 								<< typeid(*parameter).name()
 								<< " Register the type with addType before adding such a parameter.";
 		return;
 	}
+	auto& typeInfo = typeRegistry.at(std::type_index(typeid(*parameter)));
 
-	auto parameterGroup = std::dynamic_pointer_cast<ofParameterGroup>(parameter);
-	if (parameterGroup)
+	std::string value;
+	std::string min = "";
+	std::string max = "";
+	if (typeInfo.typeId != CustomTypeId)
 	{
-		serializeParameterGroup(parameterGroup, xml);
-		return;
+		dispatchBuiltinType(typeInfo.typeId, [&](auto tag)
+		{
+			using ParameterType = typename decltype(tag)::type;
+			// Safe, the type registry matched typeid(ofParameter<ParameterType>):
+			auto& typedParameter = static_cast<ofParameter<ParameterType>&>(*parameter);
+			value = valueToString(typedParameter.get());
+			if constexpr (TypeTraits<ParameterType>::hasLimits)
+			{
+				min = ofToString(typedParameter.getMin());
+				max = ofToString(typedParameter.getMax());
+			}
+			if constexpr (ArrayTraits<ParameterType>::isArray)
+			{
+				// The model brings the Client up to date, so later pushes only need the ranges that change:
+				if (valuePush || multicast)
+				{
+					// Parameters may be serialized on several threads:
+					std::string path;
+					parameterTable.getPath(index, path);
+					std::unique_lock<std::mutex> lock(arrayShadowsMutex);
+					arrayShadows.set(path, typedParameter.get());
+				}
+			}
+		});
 	}
-
-	ofXml paramXml = xml.appendChild(parameter->getEscapedName());
-
-	if (typeInfo.hasLimits)
+	else
 	{
-		auto limits = typeInfo.getLimits(parameter);
-		min = limits.first;
-		max = limits.second;
+		value = parameter->toString();
+		if (typeInfo.hasLimits)
+		{
+			auto limits = typeInfo.getLimits(parameter);
+			min = limits.first;
+			max = limits.second;
+		}
 	}
 
-	paramXml.appendAttribute(AttributeName_Type).set(typeInfo.name);
-	paramXml.appendAttribute(AttributeName_Name).set(parameter->getName());
-	paramXml.appendChild(NodeName_Value).set(parameter->toString());
+	writer.openElement(parameterTable.getEscapedName(entry));
+	writer.attribute(AttributeName_Type, typeInfo.name);
+	writer.attribute(AttributeName_Name, parameterTable.getName(entry));
+	writer.attribute(AttributeName_Id, ofToString(entry.valueBegin));
+	writer.textElement(NodeName_Value, value);
 	if (min != max)
 	{
-		paramXml.appendChild(NodeName_Min).set(min);
-		paramXml.appendChild(NodeName_Max).set(max);
+		writer.textElement(NodeName_Min, min);
+		writer.textElement(NodeName_Max, max);
 	}
-
+	writer.closeElement();
 }
 
 /**
@@ -251,12 +1191,149 @@ void Server::serializeParameter(std::shared_ptr<ofAbstractParameter> parameter,
  */
 void Server::setParameter(std::string path, std::string value)
 {
+	OFXRP_TRACE_SCOPE("Server::setParameter");
+	if (customHandlers.route(path, value)) return;
+
+	auto parameter = findParameter(path);
+	if (parameter)
+	{
+		auto typeIter = typeRegistry.find(std::type_index(typeid(*parameter)));
+		deserializeParameter(*parameter, typeIter != typeRegistry.end() ? typeIter->second.typeId : CustomTypeId, value);
+	}
+	else
+	{
+		ofLogError(ModuleName) << "setParameter Couldn't deserialize parameter: " << path << "/" << value;
+	}
+}
+
+void Server::applyParameter(const std::string& path, const std::string& value)
+{
+	OFXRP_TRACE_SCOPE("Server::setParameter");
+	if (customHandlers.route(path, value)) return;
+
+	auto index = findTableEntry(path);
+	if (index == ParameterTable::NoEntry || parameterTable[index].isGroup)
+	{
+		// Not in the table, e.g. added since the last model was sent
+		setParameter(path, value);
+		return;
+	}
+	auto& entry = parameterTable[index];
+	deserializeParameter(*entry.parameter, entry.typeId, value);
+}
+
+void Server::deserializeParameter(ofAbstractParameter& parameter, TypeId typeId, const std::string& value)
+{
+	if (inTransaction)
+	{
+		if (deserializeSilently(parameter, typeId, value))
+		{
+			transactionChanges.emplace_back(&parameter, applyingRemoteValues);
+		}
+		return;
+	}
+
+	bool isBuiltin = dispatchBuiltinType(typeId, [&](auto tag)
+	{
+		using ParameterType = typename decltype(tag)::type;
+		static_cast<ofParameter<ParameterType>&>(parameter).set(valueFromString<ParameterType>(value));
+	});
+	if (!isBuiltin)
+	{
+		parameter.fromString(value);
+	}
+}
+
+bool Server::deserializeSilently(ofAbstractParameter& parameter, TypeId typeId, const std::string& value)
+{
+	bool isChanged = false;
+	bool isBuiltin = dispatchBuiltinType(typeId, [&](auto tag)
+	{
+		using ParameterType = typename decltype(tag)::type;
+		auto& typedParameter = static_cast<ofParameter<ParameterType>&>(parameter);
+		auto newValue = valueFromString<ParameterType>(value);
+		if (valuesEqual(typedParameter.get(), newValue)) return;
+		typedParameter.setWithoutEventNotifications(newValue);
+		isChanged = true;
+	});
+	if (isBuiltin) return isChanged;
+
+	auto typeIter = typeRegistry.find(std::type_index(typeid(parameter)));
+	if (typeIter != typeRegistry.end() && typeIter->second.setSilently)
+	{
+		return typeIter->second.setSilently(parameter, value);
+	}
+	// A type that can't be set silently still notifies its listeners
+	if (parameter.toString() == value) return false;
+	parameter.fromString(value);
+	return true;
+}
+
+void Server::setTransactionMode(bool transactionMode)
+{
+	this->transactionMode = transactionMode;
+}
+
+bool Server::isTransactionMode() const
+{
+	return transactionMode;
+}
+
+void Server::applyTransaction(const std::vector<std::pair<std::string, std::string>>& writes)
+{
+	// Joins the transaction of update() if called from one of its listeners
+	bool isNested = inTransaction;
+	if (!isNested) beginTransaction();
+	for (auto& write : writes)
+	{
+		setParameter(write.first, write.second);
+	}
+	if (!isNested) endTransaction();
+}
+
+void Server::beginTransaction()
+{
+	inTransaction = true;
+	transactionChanges.clear();
+}
+
+void Server::endTransaction()
+{
+	inTransaction = false;
+	if (transactionChanges.empty()) return;
+
+	std::vector<std::string> changedPaths;
+	changedPaths.reserve(transactionChanges.size());
+	std::unordered_set<ofAbstractParameter*> seen;
+	for (auto& change : transactionChanges)
+	{
+		if (!seen.insert(change.first).second) continue;
+		changedPaths.push_back(getParameterPath(*change.first));
+		if (valuePush || multicast)
+		{
+			// The listeners that would have pushed the values were not notified
+			applyingRemoteValues = change.second;
+			pushParameter(*change.first);
+			applyingRemoteValues = false;
+		}
+	}
+	transactionChanges.clear();
+	parametersChangedEvent.notify(this, changedPaths);
+}
+
+std::shared_ptr<ofAbstractParameter> Server::findParameter(const std::string& path)
+{
+	// The table resolves the path without building strings. The groups are only walked for the parameters added
+	// since it was built, or while it can't be rebuilt.
+	auto index = findTableEntry(path);
+	if (index != ParameterTable::NoEntry && index != 0) return parameterTable[index].parameter;
+
 	auto pathComponents = ofSplitString(path, "/", true, true);
 	if (pathComponents.size() < 2)
 	{
-		ofLogError(ModuleName) << "setParameter: path is too short. Path: "
-							   << path;
-		return;
+		ofLogVerbose(ModuleName) << "findParameter: path is too short. Path: "
+								 << path;
+		return nullptr;
 	}
 
 	auto current = group;
@@ -265,11 +1342,24 @@ void Server::setParameter(std::string path, std::string value)
 
 	if (current->getEscapedName() != pathComponents[0])
 	{
-		ofLogError(ModuleName) << "setParameter: " << "Something went wrong getting a pathComponent.";
-		return;
+		ofLogVerbose(ModuleName) << "findParameter: " << "Root group does not match path: " << path;
+		return nullptr;
+	}
+
+	std::size_t first = 1;
+	if (!namespaces.empty() && pathComponents.size() > 2)
+	{
+		auto namespaceIter = namespaces.find(pathComponents[1]);
+		if (namespaceIter == namespaces.end())
+		{
+			ofLogVerbose(ModuleName) << "findParameter: " << "No group is hosted at " << path;
+			return nullptr;
+		}
+		current = namespaceIter->second;
+		first = 2;
 	}
 
-	for (int i = 1; i < pathComponents.size() - 1; i++)
+	for (std::size_t i = first; i < pathComponents.size() - 1; i++)
 	{
 		std::string pc = pathComponents[i];
 
@@ -286,41 +1376,66 @@ void Server::setParameter(std::string path, std::string value)
 		}
 		else
 		{
-			ofLogVerbose(ModuleName) << "setParameter: "
-									 << "Couldn't find parameter group. Trying custom deserializer";
-			// Try a custom deserializer here?
-			useCustomDeserializer(path, value);
-			return;
-
+			ofLogVerbose(ModuleName) << "findParameter: "
+									 << "Couldn't find parameter group " << pc;
+			return nullptr;
 		}
 	}
 
 	// If we are still here we have the group with the parameter
 	auto result = findParamWithEscapedName(*current, pathComponents.back());
-	if (result.first)
+	return result.second;
+}
+
+Server::ParameterHandle Server::getParameterHandle(const std::string& path)
+{
+	ParameterHandle handle;
+	handle.path = path;
+	handle.parameter = findParameter(path);
+	if (handle.parameter)
 	{
-		result.second->fromString(value);
+		auto typeIter = typeRegistry.find(std::type_index(typeid(*handle.parameter)));
+		if (typeIter != typeRegistry.end()) handle.typeId = typeIter->second.typeId;
 	}
 	else
 	{
-		// Try a custom deserializer here?
-		useCustomDeserializer(path, value);
+		ofLogWarning(ModuleName) << "getParameterHandle: no parameter at " << path
+								 << ". Values written with this handle will be passed to the custom deserializers.";
 	}
+	return handle;
 }
 
-bool Server::useCustomDeserializer(const std::string& path, const std::string& value) const
+void Server::enqueueParameter(const std::string& path, std::string value)
 {
-	auto iter = customDeserializers.find(path);
-	if (iter != customDeserializers.end())
-	{
-		iter->second(path + "/" + value);
-		return true;
-	}
-	else
+	ParameterWrite write;
+	write.path = path;
+	write.value = std::move(value);
+	parameterWriteQueue.push(std::move(write));
+}
+
+void Server::enqueueParameter(const ParameterHandle& handle, std::string value)
+{
+	ParameterWrite write;
+	write.parameter = handle.parameter;
+	write.typeId = handle.typeId;
+	if (!write.parameter) write.path = handle.path;
+	write.value = std::move(value);
+	parameterWriteQueue.push(std::move(write));
+}
+
+void Server::applyQueuedWrites()
+{
+	ParameterWrite write;
+	while (parameterWriteQueue.tryPop(write))
 	{
-		ofLogError(ModuleName) << "setParameter Couldn't deserialize parameter: "
-							   << path << "/" << value;
-		return false;
+		if (write.parameter)
+		{
+			deserializeParameter(*write.parameter, write.typeId, write.value);
+		}
+		else
+		{
+			setParameter(write.path, write.value);
+		}
 	}
 }
 
@@ -354,6 +1469,7 @@ bool Server::sendMetaModel()
 
 void Server::parseMessage(ofxOscMessage& m)
 {
+	OFXRP_TRACE_SCOPE("Server::parseMessage");
 	ofLogVerbose(ModuleName) << "address = " << m.getAddress();
 	for (int i = 0; i < m.getNumArgs(); i++)
 	{
@@ -376,6 +1492,8 @@ void Server::parseMessage(ofxOscMessage& m)
 		auto result = serverMethods.find(components[2]);
 		if (result != serverMethods.end())
 		{
+			// Methods are never removed, so their identifier outlives the trace:
+			OFXRP_TRACE_SCOPE(result->first.c_str());
 			result->second.execute(m, *this);
 		}
 	}
@@ -398,35 +1516,288 @@ void Server::parseMessage(ofxOscMessage& m)
 //	}
 //}
 
+bool Server::receiveReliable(ofxOscMessage& message)
+{
+	auto& address = message.getAddress();
+	auto methodStart = ApiReliable.size() + 1;
+	auto idStart = address.rfind('/');
+	if (idStart == std::string::npos || idStart <= methodStart)
+	{
+		ofLogWarning(ModuleName) << "Ignoring malformed acknowledged call " << address;
+		return false;
+	}
+	const char* idText = address.c_str() + idStart + 1;
+	char* end = nullptr;
+	auto requestId = static_cast<int32_t>(std::strtol(idText, &end, 10));
+	// strtol() returns 0 when there are no digits, which would make every such call a duplicate of request 0:
+	if (end == idText || *end != '\0')
+	{
+		ofLogWarning(ModuleName) << "Ignoring acknowledged call with an invalid request id " << address;
+		return false;
+	}
+
+	if (hasClient)
+	{
+		ofxOscMessage ack;
+		ack.setAddress(ApiResponse + "/" + MethodAck);
+		ack.addInt32Arg(requestId);
+		oscSender.sendMessage(ack);
+	}
+	// Acks get lost too, so a retransmitted call is acknowledged again but not executed twice:
+	if (!recentRequestIdSet.insert(requestId).second)
+	{
+		stats.duplicateRequests++;
+		return false;
+	}
+	recentRequestIds.push_back(requestId);
+	if (recentRequestIds.size() > ReliableHistorySize)
+	{
+		recentRequestIdSet.erase(recentRequestIds.front());
+		recentRequestIds.pop_front();
+	}
+
+	auto plainAddress = ApiRoot + "/" + address.substr(methodStart, idStart - methodStart);
+	message.setAddress(plainAddress);
+	return true;
+}
+
 void Server::sendMessage(ofxOscMessage& m)
 {
-	oscSender.sendMessage(m, false);
+	if (replaying) return;
+	oscSender.sendMessage(m);
 }
 
 void Server::sendReply(ServerMethod& method, ofxOscMessage& m)
 {
+	if (replaying) return;
 	m.setAddress(ApiResponse + "/" + method.getIdentifier());
 	ofLogVerbose(ModuleName) << "Sending " << m << " to "
 							 << oscSender.getHost() + ":" + ofToString(oscSender.getPort());
-	oscSender.sendMessage(m, false);
+	oscSender.sendMessage(m);
 }
 
-void Server::addServerMethod(ServerMethod&& method)
+bool Server::addServerMethod(ServerMethod&& method)
 {
+	if (!method.compileArguments())
+	{
+		ofLogError(ModuleName) << "addServerMethod: the arguments of " << method.getIdentifier() << " are invalid";
+		return false;
+	}
 	std::unique_lock<std::mutex> lock(serverMutex);
 	serverMethods.insert({method.getIdentifier(), method});
+	return true;
+}
+
+bool Server::ServerMethod::compileArguments()
+{
+	argumentTypes.resize(arguments.size());
+	defaultValues.resize(arguments.size());
+	requiredArgumentCount = 0;
+	for (std::size_t i = 0; i < arguments.size(); i++)
+	{
+		auto& argument = arguments[i];
+		if (!argumentTypeFromName(argument.type, argumentTypes[i]))
+		{
+			ofLogError(ModuleName) << identifier << ": unknown type " << argument.type << " for argument "
+								   << argument.identifier;
+			return false;
+		}
+		if (!argument.isOptional)
+		{
+			if (requiredArgumentCount != i)
+			{
+				ofLogError(ModuleName) << identifier << ": required argument " << argument.identifier
+									   << " follows an optional one";
+				return false;
+			}
+			requiredArgumentCount++;
+		}
+		else if (!argumentFromString(argumentTypes[i], argument.value, defaultValues[i]))
+		{
+			ofLogError(ModuleName) << identifier << ": invalid default value " << argument.value << " for argument "
+								   << argument.identifier;
+			return false;
+		}
+	}
+	decodedArguments.values = defaultValues;
+	return true;
+}
+
+bool Server::ServerMethod::decodeArguments(const ofxOscMessage& message)
+{
+	auto count = message.getNumArgs();
+	if (count < requiredArgumentCount || count > argumentTypes.size())
+	{
+		ofLogError(ModuleName) << identifier << ": expected " << requiredArgumentCount << " to "
+							   << argumentTypes.size() << " arguments, received " << count;
+		return false;
+	}
+	for (std::size_t i = 0; i < argumentTypes.size(); i++)
+	{
+		if (i >= count)
+		{
+			decodedArguments.values[i] = defaultValues[i];
+		}
+		else if (!argumentFromOsc(message, i, argumentTypes[i], decodedArguments.values[i]))
+		{
+			ofLogError(ModuleName) << identifier << ": argument " << arguments[i].identifier << " should be of type "
+								   << arguments[i].type;
+			return false;
+		}
+	}
+	return true;
+}
+
+void Server::addCustomHandler(const std::string& pattern, PathRouter::Handler handler)
+{
+	std::unique_lock<std::mutex> lock(serverMutex);
+	customHandlers.add(pattern, std::move(handler));
 }
 
 void Server::addCustomDeserializer(std::string path,
 								   std::function<void(std::string)> customDeserializer)
 {
-	std::unique_lock<std::mutex> lock(serverMutex);
-	customDeserializers[path] = customDeserializer;
+	addCustomHandler(path, [customDeserializer](std::string_view path, std::string_view value)
+	{
+		std::string serialized;
+		serialized.reserve(path.size() + 1 + value.size());
+		serialized.append(path).append("/").append(value);
+		customDeserializer(serialized);
+	});
+}
+
+bool Server::startRecording(const std::string& path)
+{
+	if (!recorder.open(path)) return false;
+	recordingStartMicros = ofGetElapsedTimeMicros();
+	ofLogNotice(ModuleName) << "Recording traffic to " << path;
+	return true;
+}
+
+void Server::stopRecording()
+{
+	if (!recorder.isOpen()) return;
+	ofLogNotice(ModuleName) << "Recorded " << recorder.getRecordCount() << " messages";
+	recorder.close();
+}
+
+bool Server::isRecording() const
+{
+	return recorder.isOpen();
+}
+
+bool Server::startReplay(const std::string& path, ReplayMode mode)
+{
+	if (!replayer.open(path)) return false;
+
+	replayStats = ReplayStats();
+	replayStartMicros = ofGetElapsedTimeMicros();
+	if (!replayer.peekTimestamp(replayFirstTimestamp))
+	{
+		ofLogWarning(ModuleName) << "Traffic log is empty: " << path;
+		replayer.close();
+		return true;
+	}
+
+	if (mode == ReplayMode::AsFastAsPossible)
+	{
+		ofxOscMessage message;
+		uint64_t timestamp;
+		while (replayer.next(message, timestamp))
+		{
+			replayMessage(message);
+		}
+		applyPendingParameters();
+		finishReplay();
+	}
+	return true;
+}
+
+void Server::stopReplay()
+{
+	if (replayer.isOpen()) finishReplay();
+}
+
+bool Server::isReplaying() const
+{
+	return replayer.isOpen();
+}
+
+const Server::ReplayStats& Server::getReplayStats() const
+{
+	return replayStats;
+}
+
+void Server::replayPendingMessages()
+{
+	auto elapsed = ofGetElapsedTimeMicros() - replayStartMicros;
+	ofxOscMessage message;
+	uint64_t timestamp;
+	while (replayer.peekTimestamp(timestamp) && timestamp - replayFirstTimestamp <= elapsed)
+	{
+		if (!replayer.next(message, timestamp)) break;
+		replayMessage(message);
+	}
+
+	if (!replayer.peekTimestamp(timestamp))
+	{
+		finishReplay();
+	}
+}
+
+void Server::replayMessage(ofxOscMessage& m)
+{
+	replayStats.messageCount++;
+	// Replaying these would hijack, shut down or talk to the session of the connected Client. getModel would also
+	// change how the model is encoded for the Client, and might be answered after the replay:
+	if (m.getAddress() == ApiRoot + "/" + MethodConnect || m.getAddress() == ApiRoot + "/" + MethodClose ||
+		m.getAddress() == ApiRoot + "/" + MethodHeartbeat || m.getAddress() == ApiRoot + "/" + MethodGetModel)
+	{
+		return;
+	}
+	// The replies to the other calls, e.g. getValues, went to the Client when they were recorded, and it isn't
+	// waiting for them now:
+	replaying = true;
+	parseMessage(m);
+	replaying = false;
+}
+
+void Server::finishReplay()
+{
+	replayStats.byteCount = replayer.getPosition() - TrafficLog::HeaderSize;
+	replayStats.elapsedMicros = ofGetElapsedTimeMicros() - replayStartMicros;
+	if (replayStats.elapsedMicros > 0)
+	{
+		replayStats.messagesPerSecond = replayStats.messageCount * 1000000.0 / replayStats.elapsedMicros;
+	}
+	replayer.close();
+	ofLogNotice(ModuleName) << "Replayed " << replayStats.messageCount << " messages ("
+							<< replayStats.byteCount << " bytes) in " << replayStats.elapsedMicros / 1000.0
+							<< " ms: " << replayStats.messagesPerSecond << " messages/s";
 }
 
 void Server::syncParameters()
 {
-	ServerMethod& method = serverMethods.at("getModel");
+	setModelRevision(modelRevision + 1);
+	// The parameters may have been restructured, which the lookups must see right away:
+	parameterTableValid = false;
+	// Announce the model on the next update():
+	if (multicast) lastAnnounceMillis = ofGetElapsedTimeMillis() - announceIntervalMillis;
+	if (!hasClient) return;
+	ServerMethod& method = serverMethods.at(MethodGetModel);
 	ofxOscMessage message;
+	if (clientAcceptsCompression) message.addStringArg(ModelEncodingDeflate);
 	method.execute(message, *this);
-}
\ No newline at end of file
+}
+
+std::string Server::getModelIdentity() const
+{
+	return instanceId + "-" + ofToString(modelRevision);
+}
+
+void Server::setModelRevision(uint32_t revision)
+{
+	modelRevision = revision;
+	// The key covers the instance as well as the revision, so ids from a previous run of the Server are rejected too:
+	modelKey = static_cast<int32_t>(std::hash<std::string>()(getModelIdentity()));
+}
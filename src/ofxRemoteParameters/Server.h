@@ -13,6 +13,21 @@
 #include <unordered_map>
 #include <typeindex>
 #include "ofxRemoteParameters.h"
+#include "ParameterTypes.h"
+#include "TrafficLog.h"
+#include "MpscQueue.h"
+#include "XmlWriter.h"
+#include "UpdateFilter.h"
+#include "PathRouter.h"
+#include "Tracing.h"
+#include "MethodArguments.h"
+#include "ModelCompression.h"
+#include "PacketSender.h"
+#include "PooledOscReceiver.h"
+#include "ParameterTable.h"
+#include "WorkerPool.h"
+#include <deque>
+#include <unordered_set>
 
 namespace ofxRemoteParameters
 {
@@ -35,6 +50,11 @@ namespace ofxRemoteParameters
 		static const std::string NodeName_Value;
 		static const std::string NodeName_Min;
 		static const std::string NodeName_Max;
+		static const std::string NodeName_Argument;
+		static const std::string AttributeName_Info;
+		static const std::string AttributeName_Default;
+		static const std::string AttributeName_Id;
+		static const std::string AttributeName_ModelKey;
 
 		class ServerMethod
 		{
@@ -49,19 +69,45 @@ namespace ofxRemoteParameters
 			}
 
 			/**
-			 * @brief These are not implemented by the Server yet.
+			 * @brief Describes an argument of the method. Arguments are advertised in the Methods section of the
+			 * model, and decoded into MethodArguments for methods created with a typed action.
 			 */
 			struct Argument
 			{
 				std::string identifier;
+				/// A description for the client UI
 				std::string info;
+				/// "int", "float", "double", "bool", "string" or "blob"
 				std::string type;
+				/// The default value of an optional argument, in text form
 				std::string value;
+				/// Optional arguments can be left out of a call, and take their default value. They must come last.
+				bool isOptional = false;
 			};
 
 			/**
-			 * @brief Not implemented by Server yet.
+			 * @brief Creates a method whose arguments are checked and decoded before the action is called, so that
+			 * the action can use them without parsing them. Calls with missing or mistyped arguments are rejected
+			 * with an error, without calling the action.
+			 * @code
+			 * server.addServerMethod(ServerMethod("fade", "Fade", {{"seconds", "Fade time", "float"}},
+			 *		[](ServerMethod& method, const MethodArguments& arguments, Server& server)
+			 *		{
+			 *			startFade(arguments.get<float>(0));
+			 *		}));
+			 * @endcode
 			 */
+			ServerMethod(std::string ident,
+						 std::string uiName,
+						 std::vector<Argument> arguments,
+						 std::function<void(ServerMethod&, const MethodArguments&, Server&)> typedAction)
+			{
+				identifier = ident;
+				this->uiName = uiName;
+				this->arguments = std::move(arguments);
+				this->typedAction = typedAction;
+			}
+
 			void addArgument(Argument& arg)
 			{
 				arguments.push_back(arg);
@@ -69,9 +115,21 @@ namespace ofxRemoteParameters
 
 			void execute(ofxOscMessage& message, Server& server)
 			{
-				action(*this, message, server);
+				if (!typedAction)
+				{
+					action(*this, message, server);
+					return;
+				}
+				if (decodeArguments(message)) typedAction(*this, decodedArguments, server);
 			}
 
+			/**
+			 * @brief Checks the argument schema, and prepares the decoding of the arguments. Called by
+			 * Server::addServerMethod().
+			 * @return false if a type is unknown, a default value doesn't parse, or a required argument follows an
+			 * optional one.
+			 */
+			bool compileArguments();
 
 		protected:
 			/**
@@ -97,8 +155,22 @@ namespace ofxRemoteParameters
 			* dispatched the method.
 			**/
 			std::function<void(ServerMethod&, ofxOscMessage&, Server&)> action;
+			/**
+			 * @brief Used instead of action when set: receives the decoded arguments instead of the message.
+			 */
+			std::function<void(ServerMethod&, const MethodArguments&, Server&)> typedAction;
 
 			std::vector<Argument> arguments;
+
+		private:
+			bool decodeArguments(const ofxOscMessage& message);
+
+			std::vector<ArgumentType> argumentTypes;
+			std::vector<ArgumentValue> defaultValues;
+			std::size_t requiredArgumentCount = 0;
+			/// Reused by every call, so that decoding doesn't allocate for numeric arguments
+			MethodArguments decodedArguments;
+
 		public:
 			const std::string& getIdentifier() const
 			{
@@ -110,6 +182,11 @@ namespace ofxRemoteParameters
 				return uiName;
 			}
 
+			const std::vector<Argument>& getArguments() const
+			{
+				return arguments;
+			}
+
 		};
 
 		Server();
@@ -125,6 +202,25 @@ namespace ofxRemoteParameters
 				   int inPort = DefaultServerInPort,
 				   int outPort = DefaultServerOutPort);
 
+		/**
+		 * @brief Sets up and starts the Server without parameters, to host several groups added with addGroup() on
+		 * the same ports and receiver thread.
+		 * @param name The name of the root group of the model, which contains the hosted groups.
+		 */
+		void setup(const std::string& name,
+				   int inPort = DefaultServerInPort,
+				   int outPort = DefaultServerOutPort);
+
+		/**
+		 * @brief Hosts a group on a Server set up with a name. The escaped name of the group is its namespace: the
+		 * group is a child of the root group in the model, and its parameters are at /(root)/(namespace)/...
+		 * Messages are routed to their group by a single lookup of the namespace, however many groups are hosted.
+		 * Like syncParameters(), this starts a new revision of the model, which is sent again to a connected Client
+		 * and announced to the observers.
+		 * @return false if the Server was set up with a group, or if the name is empty or already hosted.
+		 */
+		bool addGroup(ofParameterGroup& parameters);
+
 		/**
 		 * @brief The Server needs to continuously check for incoming OSC messages by calling Server::update(), and this
 		 * method determines whether Server should do this automatically.\line
@@ -136,8 +232,112 @@ namespace ofxRemoteParameters
 		void setAutoUpdate(bool autoUpdate);
 		void sendMessage(ofxOscMessage& m);
 		void sendReply(ServerMethod& method, ofxOscMessage& m);
-		void addServerMethod(ServerMethod&& method);
+		/**
+		 * @brief Adds a method that clients can call through /ofxrpMethod/(identifier).
+		 * @return false if the argument schema of the method is invalid, see ServerMethod::compileArguments().
+		 */
+		bool addServerMethod(ServerMethod&& method);
 		void setParameter(std::string path, std::string value);
+
+		/**
+		 * @brief A parameter resolved once with getParameterHandle(), so that writes through it skip the path lookup.
+		 */
+		class ParameterHandle
+		{
+		public:
+			/**
+			 * @brief Whether the handle refers to a parameter. Writes through an invalid handle are passed to the
+			 * custom deserializers with the handle's path, like Server::setParameter() does.
+			 */
+			bool isValid() const { return parameter != nullptr; }
+			const std::string& getPath() const { return path; }
+
+		private:
+			friend class Server;
+			std::shared_ptr<ofAbstractParameter> parameter;
+			TypeId typeId = CustomTypeId;
+			std::string path;
+		};
+
+		/**
+		 * @brief Resolves the parameter at path. Call this from the main thread, for example after setup().
+		 */
+		ParameterHandle getParameterHandle(const std::string& path);
+
+		/**
+		 * @brief Thread-safe version of setParameter() that can be called from any thread. The value is queued without
+		 * taking a lock and applied on the main thread by the next update(), after the values received over OSC.
+		 * Writes are applied in the order they were queued.
+		 * @note Queuing a write allocates (the value string and a queue node), so it doesn't wait on the main thread
+		 * but may wait on the heap.
+		 * @param path The path for the ofParameter in the ofParameterGroup hierarchy.
+		 * @param value The value for the parameter in string form.
+		 */
+		void enqueueParameter(const std::string& path, std::string value);
+		/**
+		 * @brief Thread-safe write to a parameter resolved with getParameterHandle(). See enqueueParameter(const std::string&, std::string).
+		 */
+		void enqueueParameter(const ParameterHandle& handle, std::string value);
+
+		template<typename ParameterType>
+		void enqueueParameter(const ParameterHandle& handle, const ParameterType& value)
+		{
+			enqueueParameter(handle, ofToString(value));
+		}
+
+		/**
+		 * @brief In transaction mode, the values that update() receives from the Client and from enqueueParameter()
+		 * are applied as one batch per frame: parameters are set without notifying their listeners or their groups,
+		 * values equal to the current ones are skipped, and parametersChangedEvent is notified once at the end of the
+		 * batch with the paths of the parameters that changed. Array ranges and custom handlers are not part of the
+		 * batch.
+		 */
+		void setTransactionMode(bool transactionMode);
+		bool isTransactionMode() const;
+		/**
+		 * @brief Applies {path, value} pairs as one transaction, whatever the transaction mode. See setTransactionMode().
+		 */
+		void applyTransaction(const std::vector<std::pair<std::string, std::string>>& writes);
+		/**
+		 * @brief Notified at the end of each transaction with the paths of the parameters whose value changed. Not
+		 * notified if none did.
+		 */
+		ofEvent<std::vector<std::string>> parametersChangedEvent;
+
+		/**
+		 * @brief Overwrites count elements of an array parameter starting at offset, growing the array if needed.
+		 * offset can be at most the size of the array.
+		 * Only the elements that changed are pushed to the Client and the observers.
+		 * @tparam Element int, float, glm::vec2, glm::vec3 or glm::vec4.
+		 */
+		template<typename Element>
+		void setRange(const std::string& path, std::size_t offset, const std::vector<Element>& values)
+		{
+			auto parameter = std::dynamic_pointer_cast<ofParameter<std::vector<Element>>>(findParameter(path));
+			if (!parameter)
+			{
+				ofLogError(ModuleName) << "setRange: there is no array parameter of that type at " << path;
+				return;
+			}
+			if (!writeRange(*parameter, offset, values.data(), values.size()))
+			{
+				ofLogError(ModuleName) << "setRange: offset " << offset << " is past the end of " << path;
+			}
+		}
+
+		/**
+		 * @brief Handles values set for paths that match pattern, instead of the parameter tree. Use it for values that
+		 * aren't ofParameters, e.g. the properties of entities that come and go. In the pattern, `*` matches one path
+		 * component, so "/Scene/Lights/ * /intensity" (without the spaces) matches the intensity of every light.
+		 * Handlers are looked up before the parameter tree, through the trie of a PathRouter: unless patterns overlap
+		 * an exact component with `*`, this takes time proportional to the length of the path, however many there
+		 * are. The path and value passed to the handler are only valid during the call.
+		 */
+		void addCustomHandler(const std::string& pattern, PathRouter::Handler handler);
+		/**
+		 * @brief Handles values set for exactly this path. The deserializer receives the path and the value joined
+		 * with a slash. Prefer addCustomHandler(), which avoids building that string.
+		 */
 		void addCustomDeserializer(std::string path,
 								   std::function<void(std::string serializedString)> customDeserializer);
 		void close();
@@ -172,6 +372,21 @@ namespace ofxRemoteParameters
 			 */
 			std::function<std::pair<std::string, std::string>(
 					std::shared_ptr<ofAbstractParameter> parameter)> getLimits;
+			/**
+			 * @brief Set automatically for the built-in types, which are then (de)serialized through a switch on this
+			 * id instead of virtual calls and getLimits. Leave it as CustomTypeId for other types.
+			 */
+			TypeId typeId = CustomTypeId;
+			/**
+			 * @brief The filter for the value updates that the Server pushes for parameters of this type. Filters set
+			 * for a path pattern with setUpdateFilter() take precedence.
+			 */
+			UpdateFilter updateFilter;
+			/**
+			 * @brief Sets the value of a parameter of a custom type without notifying its listeners, for transactions.
+			 * @return false if the value was already equal. Set automatically by addParameterType().
+			 */
+			std::function<bool(ofAbstractParameter& parameter, const std::string& value)> setSilently;
 		};
 
 		/**
@@ -190,6 +405,7 @@ namespace ofxRemoteParameters
 			TypeInfo info;
 			info.name = typeName;
 			info.hasLimits = hasLimits;
+			info.typeId = builtinTypeId<ParameterType>();
 			if (hasLimits)
 			{
 				// This lambda casts the parameter to its actual type and provides min and max.
@@ -203,11 +419,37 @@ namespace ofxRemoteParameters
 					return limits;
 				};
 			}
+			if constexpr (builtinTypeId<ParameterType>() == CustomTypeId)
+			{
+				info.setSilently = [](ofAbstractParameter& parameter, const std::string& value)
+				{
+					// Custom types may not have an operator==, so their serialized values are compared
+					if (parameter.toString() == value) return false;
+					static_cast<ofParameter<ParameterType>&>(parameter)
+							.setWithoutEventNotifications(ofFromString<ParameterType>(value));
+					return true;
+				};
+			}
 			auto result = typeRegistry.insert({std::type_index(typeid(ofParameter<ParameterType>)), info});
 			if (!result.second) ofLogWarning("ModelServer") << "Tried to add an existing type";
 		}
 
 
+		/**
+		 * @brief Registers every type in a TypeList in one call, with the name and limits given by its TypeTraits.
+		 * Registering the same list with Client::addParameterTypes() guarantees that both sides use the same names.
+		 * @tparam List A TypeList, e.g. TypeList<MyType, MyOtherType>.
+		 */
+		template<typename List>
+		void addParameterTypes()
+		{
+			forEachType(List(), [this](auto tag)
+			{
+				using ParameterType = typename decltype(tag)::type;
+				addParameterType<ParameterType>(TypeTraits<ParameterType>::name, TypeTraits<ParameterType>::hasLimits);
+			});
+		}
+
 		/**
 		 * @brief Use this method to add Server support for additional ofParameter types. It is highly recommended that you
 		 * use the addParameterType(std::string typeName, bool hasLimits = false) method instead.
@@ -221,6 +463,51 @@ namespace ofxRemoteParameters
 			if (!result.second) ofLogWarning("ModelServer") << "Tried to add an existing type";
 		}
 
+		/**
+		 * @brief Sends the new value of a parameter to the connected Client whenever it changes on the Server side,
+		 * for example from the app or from enqueueParameter(). Values set by the Client are not sent back to it.
+		 * Off by default.
+		 * @see setUpdateFilter() to keep noisy parameters from flooding the Client.
+		 */
+		void setValuePush(bool enabled);
+		bool getValuePush() const;
+
+		/**
+		 * @brief Publishes the model and the value updates to a multicast group, where any number of observers
+		 * (see Client::setupObserver()) can follow them at no additional cost for the Server. The model is announced
+		 * periodically, so that observers that join late get it too, and right after syncParameters(). Values are
+		 * published whenever they change, including those set by the Client, and go through the update filters.
+		 * @param groupAddress A multicast address, e.g. 239.255.0.1.
+		 * @param port The port that the observers listen to.
+		 * @param announceIntervalMillis How often to announce the model.
+		 * @return false if the multicast sender could not be set up.
+		 */
+		bool startMulticast(const std::string& groupAddress, int port, uint64_t announceIntervalMillis = 2000);
+		void stopMulticast();
+		bool isMulticasting() const;
+
+		/**
+		 * @brief Filters the values pushed for the parameters whose path matches pathPattern (see
+		 * UpdateFilterSet::setPathFilter()).
+		 */
+		void setUpdateFilter(const std::string& pathPattern, const UpdateFilter& filter);
+
+		/**
+		 * @brief Filters the values pushed for every parameter of the given type, by setting the updateFilter of its
+		 * TypeInfo. The type must already be registered.
+		 */
+		template<typename ParameterType>
+		void setUpdateFilter(const UpdateFilter& filter)
+		{
+			auto typeIter = typeRegistry.find(std::type_index(typeid(ofParameter<ParameterType>)));
+			if (typeIter == typeRegistry.end())
+			{
+				ofLogWarning(ModuleName) << "setUpdateFilter: the type is not registered";
+				return;
+			}
+			typeIter->second.updateFilter = filter;
+		}
+
 		/**
 		 * @brief Checks for incoming OSC messages. If auto updates are enabled you do not need to call this
 		 * method.
@@ -228,6 +515,86 @@ namespace ofxRemoteParameters
 		 */
 		void update();
 
+		/**
+		 * @brief Limits the time that update() spends on incoming messages. Work is done in priority order: parameter
+		 * sets are always applied, then method calls are executed until the budget runs out, and finally the model
+		 * is serialized for pending getModel requests. Method calls and model serialization that don't fit are
+		 * carried over to the next frames, and reported in getStats().
+		 * @note A model that is serialized over several frames may mix values from different frames.
+		 * @param budgetMicros The budget in microseconds, or 0 (the default) for no limit. Without a limit, the
+		 * model is serialized as soon as it is requested.
+		 */
+		void setFrameBudget(uint64_t budgetMicros);
+		uint64_t getFrameBudget() const;
+
+		/**
+		 * @brief Serializes large models on several threads. Sibling groups (or runs of siblings) are written into
+		 * separate buffers concurrently, and stitched together in order, so the model is the same text as when it is
+		 * serialized on one thread. Only used for models of at least 2048 parameters, and not when the model is
+		 * serialized over several frames because of a frame budget.
+		 * @note Parameters are read from the worker threads while the main thread waits for them, so custom types
+		 * must be safe to serialize from another thread.
+		 * @param threads The number of threads, including the main thread. 1 (the default) serializes on the main
+		 * thread only, 0 uses one thread per core. The other threads are started here and sleep between models.
+		 */
+		void setSerializationThreads(std::size_t threads);
+		std::size_t getSerializationThreads() const;
+
+		struct Stats
+		{
+			/// Method calls that have been received but not executed yet, because the frame budget ran out.
+			std::size_t pendingMethodCalls = 0;
+			/// getModel requests waiting for the model serialization in progress.
+			std::size_t pendingModelRequests = 0;
+			/// Progress of the model serialization in progress, from 0 to 1.
+			float modelSerializationProgress = 0;
+			/// Duration of the last update(), in microseconds.
+			uint64_t lastUpdateMicros = 0;
+			/// Number of update() calls that took longer than the frame budget.
+			std::size_t budgetOverruns = 0;
+			/// Size of the last model that was sent, before compression.
+			std::size_t lastModelBytes = 0;
+			/// Size of the last model that was sent compressed.
+			std::size_t lastCompressedModelBytes = 0;
+			/// Uncompressed size over compressed size, for the last model that was sent compressed.
+			float lastCompressionRatio = 0;
+			/// Time spent compressing the last model that was sent compressed, in microseconds.
+			uint64_t lastCompressionMicros = 0;
+			/// Acknowledged calls that were received again, because their ack was lost, and not executed twice.
+			std::size_t duplicateRequests = 0;
+			/// Outbound packets waiting for the pacer, to the Client and the multicast group.
+			std::size_t queuedPackets = 0;
+			std::size_t queuedBytes = 0;
+			/// Outbound packets dropped because the pacer's queue was full.
+			std::size_t droppedPackets = 0;
+			/// Estimated memory used by the flat table of the parameters, which the Server keeps between models.
+			std::size_t parameterTableBytes = 0;
+			/// Models announced to the multicast group, and how many of them had to be serialized. The others
+			/// repeated the previous announce, since neither the model nor any value had changed.
+			std::size_t modelAnnouncements = 0;
+			std::size_t serializedAnnouncements = 0;
+		};
+
+		/**
+		 * @brief Compresses the getModel replies with zlib for Clients that ask for it, when the model is at least
+		 * minimumBytes long. Enabled by default. Clients handle compressed models transparently, while older clients
+		 * don't ask for them and keep getting text. Models announced to multicast observers are never compressed.
+		 * The ratio and the time spent are reported in getStats().
+		 */
+		void setModelCompression(bool enabled, std::size_t minimumBytes = 1024);
+
+		/**
+		 * @brief Paces the packets sent to the Client and to the multicast group with a token bucket each, so that
+		 * bursts of replies and values don't overflow the receive buffers of slow devices. Up to burstBytes are sent
+		 * at once, then bytesPerSecond on average. The packets over the budget are queued and sent by the next
+		 * update() calls, in order, and new packets are dropped while maxQueuedBytes are queued. The queue and the
+		 * drops are reported in getStats().
+		 * @param bytesPerSecond The average rate, or 0 (the default) to send packets as soon as they are ready.
+		 */
+		void setPacing(uint64_t bytesPerSecond, std::size_t burstBytes = 16384, std::size_t maxQueuedBytes = 1 << 20);
+
+		const Stats& getStats() const;
+
 		struct ParameterData
 		{
 			std::string parameterPath;
@@ -237,30 +604,188 @@ namespace ofxRemoteParameters
 		/**
 		 * @brief Re-sends the ofParameterGroup and ServerMethods to the connected Client. This is useful when the
 		 * parameters are changed server-side and you want the Client to reflect those changes. Also useful if new
-		 * paremeters are added to the ofParameterGroup.
+		 * paremeters are added to the ofParameterGroup. The model is also announced to the multicast observers on
+		 * the next update(), whether or not a Client is connected.
 		 * @note In most situations you do not need to call this method.
 		 */
 		void syncParameters();
 
+		/**
+		 * @brief Identifies the model currently served, so that a Client that reconnects can tell whether the model
+		 * it already has is still valid. It changes when the Server is restarted, every time syncParameters()
+		 * is called, and when the Server finds that the structure of the parameters changed.
+		 */
+		std::string getModelIdentity() const;
+
+		enum class ReplayMode
+		{
+			/// Messages are fed to the Server from update() with the same timing they were recorded with.
+			RealTime,
+			/// All messages are fed to the Server immediately from startReplay().
+			AsFastAsPossible
+		};
+
+		struct ReplayStats
+		{
+			std::size_t messageCount = 0;
+			std::size_t byteCount = 0;
+			uint64_t elapsedMicros = 0;
+			double messagesPerSecond = 0;
+		};
+
+		/**
+		 * @brief Starts appending every received message, along with its arrival time, to a binary traffic log.
+		 * @param path The path of the log file. An existing file will be overwritten.
+		 * @return false if the log file could not be opened.
+		 */
+		bool startRecording(const std::string& path);
+		void stopRecording();
+		bool isRecording() const;
+
+		/**
+		 * @brief Feeds a traffic log recorded with startRecording() back into the Server, as if the messages had been
+		 * received over OSC. The connect, close, heartbeat and getModel methods are skipped, and the other methods
+		 * don't send their replies, so that a replay does not disturb the current Client session. Values that the
+		 * replay changes are still pushed as usual.
+		 * @param path The path of the log file.
+		 * @param mode Whether to preserve the recorded timing or to replay the log as fast as possible. In the latter
+		 * case the replay is finished by the time this method returns, and the throughput is available from
+		 * getReplayStats().
+		 * @return false if the log could not be opened.
+		 */
+		bool startReplay(const std::string& path, ReplayMode mode = ReplayMode::RealTime);
+		void stopReplay();
+		bool isReplaying() const;
+		/**
+		 * @brief The statistics of the current replay, or of the last finished one.
+		 */
+		const ReplayStats& getReplayStats() const;
+
+	protected:
+		/**
+		 * @brief Serializes the whole model at once.
+		 */
+		std::string createMetaModel();
+
 	private:
-		ofXml createMetaModel();
 		bool sendMetaModel();
+		void startModelSerialization();
+		/**
+		 * @brief Serializes the model until it is complete or the deadline passes.
+		 * @return true if the model is complete.
+		 */
+		bool serializeModelStep(uint64_t deadlineMicros);
+		void finishModelSerialization();
+		void finishModelDocument(XmlWriter& writer);
+		/**
+		 * @brief One step of stitching a model serialized in parallel: a fragment written by a task, the start of a
+		 * group that was split into tasks (group is set), or the end of one (task is CloseGroup).
+		 */
+		struct SerializationStep
+		{
+			static const std::size_t CloseGroup = static_cast<std::size_t>(-1);
+			ParameterTable::Index group;
+			std::size_t task;
+		};
+		/**
+		 * @brief A range of consecutive siblings in parameterTable, with their subtrees, serialized on a worker
+		 * thread.
+		 */
+		struct SerializationTask
+		{
+			ParameterTable::Index begin;
+			ParameterTable::Index end;
+			/// The depth of the siblings in the document, for indentation
+			std::size_t depth;
+		};
+		void serializeModelParallel();
+		void planSerialization(ParameterTable::Index parent,
+							   std::size_t depth,
+							   std::size_t taskSize,
+							   std::vector<SerializationStep>& plan,
+							   std::vector<SerializationTask>& tasks);
+		/**
+		 * @brief Writes the entries [begin, end) of parameterTable, which must be whole subtrees of siblings.
+		 */
+		void serializeEntries(ParameterTable::Index begin, ParameterTable::Index end, XmlWriter& writer);
+		/**
+		 * @brief Adds the model to a getModel reply, as a zlib blob if compress is set and compression is worth it.
+		 */
+		void addModelArgument(ofxOscMessage& message, const std::string& model, bool compress);
+		/**
+		 * @brief Writes the model identity, the subtree path and the values of the parameters in the subtree, in
+		 * model order, for getValues.
+		 * @return false if there is nothing at subtreePath.
+		 */
+		bool serializeValues(const std::string& subtreePath, ofxOscMessage& message);
 		void parseMessage(ofxOscMessage& m);
-		void serializeParameterGroup(std::shared_ptr<ofParameterGroup> params, ofXml& xml);
-		void serializeParameter(std::shared_ptr<ofAbstractParameter> parameter, ofXml& xml);
-		void serializeMethods(ofXml& xml);
+		void applyPendingParameters();
+		void applyQueuedWrites();
+		std::shared_ptr<ofAbstractParameter> findParameter(const std::string& path);
+		void deserializeParameter(ofAbstractParameter& parameter, TypeId typeId, const std::string& value);
+		/**
+		 * @return false if the parameter already had the value.
+		 */
+		bool deserializeSilently(ofAbstractParameter& parameter, TypeId typeId, const std::string& value);
+		void beginTransaction();
+		void endTransaction();
+		void replayMessage(ofxOscMessage& m);
+		/**
+		 * @brief Acknowledges a call received through ApiReliable and turns it into a plain call.
+		 * @return false if the call is malformed or was already received, and must not be executed.
+		 */
+		bool receiveReliable(ofxOscMessage& message);
+		void replayPendingMessages();
+		void finishReplay();
+		void openParameterGroup(const ParameterTable::Entry& entry, XmlWriter& writer);
+		void serializeParameter(ParameterTable::Index index, XmlWriter& writer);
+		void serializeMethods(XmlWriter& writer);
+		void pushParameter(ofAbstractParameter& parameter);
+		void sendValue(const std::string& path, const std::string& value, bool toClient = true);
+		void sendRange(const std::string& path, std::size_t offset, const ofBuffer& values, bool toClient);
+		/**
+		 * @brief Sends the update encoded in updateWriter to the Client and to the multicast group.
+		 */
+		void sendUpdate(bool toClient);
+		void applyRange(const std::string& path, int32_t offset, const ofBuffer& values);
+
+		template<typename Element>
+		void pushArray(const std::string& path, const std::vector<Element>& values, bool toClient)
+		{
+			std::size_t offset;
+			std::size_t count;
+			if (!arrayShadows.diff(path, values, offset, count))
+			{
+				sendValue(path, arrayToString(values), toClient);
+			}
+			else if (count > 0)
+			{
+				sendRange(path, offset, arrayToBlob(values.data() + offset, count), toClient);
+			}
+		}
+		void updateValueListener();
+		void announceModel(const std::string& model);
+		void cacheAnnouncedModel(std::string model, uint32_t revision);
+		std::string getParameterPath(const ofAbstractParameter& parameter) const;
 		int inPort;
 		int outPort;
-		ofxOscSender oscSender;
-		ofxOscReceiver oscReceiver;
+		PacketSender oscSender;
+		PooledOscReceiver oscReceiver;
+		/// Handed back and forth with oscReceiver, so that receiving doesn't allocate
+		PooledOscReceiver::Entries receivedMessages;
+		OscPacketWriter updateWriter;
 		std::shared_ptr<ofParameterGroup> group;
+		/// The groups hosted with addGroup(), by namespace. Empty if the Server was set up with a group.
+		std::unordered_map<std::string, std::shared_ptr<ofParameterGroup>> namespaces;
+		/// Whether the Server was set up with a name, and group is the root of the hosted groups
+		bool hostsGroups = false;
 		std::unique_ptr<of::priv::AbstractEventToken> loopListener;
 
 		/// {type hash code, type friendly name}
 
 		std::unordered_map<std::type_index, TypeInfo> typeRegistry = {};
 
-		std::unordered_map<std::string, std::function<void(std::string)>> customDeserializers = {};
+		PathRouter customHandlers;
 
 		std::unordered_map<std::string, ServerMethod> serverMethods;
 
@@ -282,10 +807,159 @@ namespace ofxRemoteParameters
 		std::pair<bool, std::shared_ptr<ofAbstractParameter>>
 		findParamWithEscapedName(ofParameterGroup& groupToSearch, std::string escapedName);
 
-		bool useCustomDeserializer(const std::string& path, const std::string& value) const;
+		/**
+		 * @brief Queues a value received from the Client, to be applied by applyPendingParameters().
+		 */
+		void queueParameter(const std::string& path, const std::string& value);
+		/**
+		 * @brief Queues a value received through setById. Ids are only accepted with the key of the current model.
+		 */
+		void queueParameterById(int32_t modelKey, int32_t id, const std::string& value);
+		bool isCurrentModelId(int32_t modelKey, int32_t id);
+		/**
+		 * @return The slot of pendingValues for path, created if needed.
+		 */
+		std::size_t findPendingSlot(const std::string& path);
+		void queueValue(std::size_t slot, const std::string& value);
+		/**
+		 * @brief Like setParameter(), for the values received from the Client.
+		 */
+		void applyParameter(const std::string& path, const std::string& value);
 
-		ofThreadChannel<ParameterData> parameterThreadChannel;
+		struct PendingValue
+		{
+			std::string path;
+			std::string value;
+			bool isPending = false;
+			/// The id of the parameter if it was received by id, so that applying it is an index into parameterTable
+			int32_t id = -1;
+		};
+		/**
+		 * @brief The values received from the Client, coalesced so that only the last one of each path is applied.
+		 * The slots of the paths seen before are kept, along with the capacity of their strings, so that steady
+		 * traffic doesn't allocate.
+		 */
+		std::vector<PendingValue> pendingValues;
+		std::unordered_map<std::string, std::size_t> pendingValueSlots;
+		/// The slots of pendingValues to apply, in the order their paths were first received
+		std::vector<std::size_t> pendingValueOrder;
+		/// The slot of pendingValues for each id, or NoSlot
+		std::vector<std::size_t> idSlots;
+		static const std::size_t NoSlot = static_cast<std::size_t>(-1);
+		/// Past this many paths, which only a misbehaving Client would send, the slots are dropped
+		static const std::size_t MaxPendingValueSlots = 65536;
 		std::mutex serverMutex;
+
+		struct ParameterWrite
+		{
+			std::shared_ptr<ofAbstractParameter> parameter;
+			TypeId typeId = CustomTypeId;
+			std::string path;
+			std::string value;
+		};
+		MpscQueue<ParameterWrite> parameterWriteQueue;
+
+		bool valuePush = false;
+		ofEventListener valuePushListener;
+		/// Set while the values received from the Client are applied, so that they are not pushed back to it
+		bool applyingRemoteValues = false;
+		bool hasClient = false;
+		bool transactionMode = false;
+		bool inTransaction = false;
+		/// The parameters changed by the current transaction, and whether the change came from the Client
+		std::vector<std::pair<ofAbstractParameter*, bool>> transactionChanges;
+		UpdateFilterSet updateFilters;
+		/// The array values that the Client and the observers have, to push only the ranges that changed
+		ArrayShadows<std::string> arrayShadows;
+		std::mutex arrayShadowsMutex;
+		std::size_t serializationThreads = 1;
+		/// The threads that help the main thread serialize, serializationThreads - 1 of them
+		WorkerPool serializationPool;
+
+		PacketSender multicastSender;
+		bool multicast = false;
+		uint64_t announceIntervalMillis = 0;
+		uint64_t lastAnnounceMillis = 0;
+		/// The model last announced to the observers, announced again until the revision or a value changes
+		std::string announcedModel;
+		uint32_t announcedModelRevision = 0;
+		bool announcedModelValid = false;
+
+		std::string instanceId;
+		uint32_t modelRevision = 0;
+		/// A hash of the model identity, which setById calls must match
+		int32_t modelKey = 0;
+		void setModelRevision(uint32_t revision);
+
+		/**
+		 * @brief The groups and parameters in model order. The model is written from it, and it resolves paths and
+		 * ids without walking the groups. It is checked against the groups before each model serialization, and only
+		 * rebuilt if their structure changed.
+		 */
+		ParameterTable parameterTable;
+		bool parameterTableValid = false;
+		/// The revision when parameterTable was built
+		uint32_t parameterTableRevision = 0;
+		/**
+		 * @brief Calls refreshParameterTable() if parameterTable isn't valid, unless a model is being serialized from
+		 * it.
+		 */
+		void ensureParameterTable();
+		/**
+		 * @brief Rebuilds parameterTable if the structure of the groups changed since it was built. In that case, if
+		 * syncParameters() wasn't called since, this also starts a new revision of the model.
+		 */
+		void refreshParameterTable();
+		/**
+		 * @brief Finds path in parameterTable. If the entry is detached from the groups, the table is rebuilt and
+		 * searched again.
+		 * @return The entry, or NoEntry if the path isn't in the table or the table can't be rebuilt right now.
+		 */
+		ParameterTable::Index findTableEntry(const std::string& path);
+		/// Reused by the lookups that need the path of an entry
+		std::string tablePath;
+
+		bool modelCompression = true;
+		std::size_t compressionMinimumBytes = 1024;
+		/// Whether the last getModel request of the Client accepted a compressed model
+		bool clientAcceptsCompression = false;
+
+		uint64_t frameBudgetMicros = 0;
+		std::deque<ofxOscMessage> pendingMethodCalls;
+		Stats stats;
+		/// How many request ids of acknowledged calls are remembered to suppress the retransmitted duplicates
+		static const std::size_t ReliableHistorySize = 256;
+		std::deque<int32_t> recentRequestIds;
+		std::unordered_set<int32_t> recentRequestIdSet;
+
+		struct ModelSerializationJob
+		{
+			bool active = false;
+			XmlWriter writer;
+			/// The groups whose element is open, innermost last
+			std::vector<ParameterTable::Index> openGroups;
+			/// The next entry of parameterTable to write
+			ParameterTable::Index nextEntry = 0;
+			std::size_t parametersWritten = 0;
+			std::size_t parameterCount = 0;
+			std::size_t pendingRequests = 0;
+			/// Whether to announce the model to the multicast group once it is serialized
+			bool announce = false;
+			/// The revision of the model being serialized
+			uint32_t revision = 0;
+			/// Whether the getModel requests waiting for the model accept it compressed
+			bool compress = false;
+		};
+		ModelSerializationJob modelJob;
+
+		TrafficRecorder recorder;
+		uint64_t recordingStartMicros = 0;
+		TrafficReplayer replayer;
+		/// Set while a replayed message is parsed, to keep the replies of the methods from going to the Client
+		bool replaying = false;
+		ReplayStats replayStats;
+		uint64_t replayStartMicros = 0;
+		uint64_t replayFirstTimestamp = 0;
 	};
 }
 
@@ -0,0 +1,167 @@
+//
+// Scoped trace spans recorded into per-thread ring buffers and exported as Chrome trace events.
+//
+
+#include "Tracing.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "ofUtils.h"
+
+using namespace ofxRemoteParameters;
+
+namespace
+{
+	struct Span
+	{
+		const char* name;
+		uint64_t startMicros;
+		uint64_t durationMicros;
+	};
+
+	/**
+	 * @brief The spans of one thread. Only that thread writes to it, so its mutex is only contended while the spans
+	 * are exported.
+	 */
+	struct ThreadSpans
+	{
+		std::mutex mutex;
+		std::vector<Span> spans;
+		/// The total number of spans recorded. The ring holds the last SpansPerThread of them.
+		std::size_t recorded = 0;
+		int threadId;
+	};
+
+	struct Registry
+	{
+		std::mutex mutex;
+		/// Kept after their thread exits, so that its spans can still be exported
+		std::vector<std::shared_ptr<ThreadSpans>> threads;
+	};
+
+	Registry& getRegistry()
+	{
+		static Registry registry;
+		return registry;
+	}
+
+	ThreadSpans& getThreadSpans()
+	{
+		thread_local std::shared_ptr<ThreadSpans> threadSpans;
+		if (!threadSpans)
+		{
+			threadSpans = std::make_shared<ThreadSpans>();
+			threadSpans->spans.resize(Tracing::SpansPerThread);
+			auto& registry = getRegistry();
+			std::unique_lock<std::mutex> lock(registry.mutex);
+			threadSpans->threadId = static_cast<int>(registry.threads.size()) + 1;
+			registry.threads.push_back(threadSpans);
+		}
+		return *threadSpans;
+	}
+
+	void appendJsonString(std::string& json, const char* text)
+	{
+		json += '"';
+		for (auto c = text; *c != '\0'; c++)
+		{
+			if (*c == '"' || *c == '\\') json += '\\';
+			if (static_cast<unsigned char>(*c) >= 0x20) json += *c;
+		}
+		json += '"';
+	}
+}
+
+bool Tracing::isEnabled()
+{
+#ifdef OFXRP_ENABLE_TRACING
+	return true;
+#else
+	return false;
+#endif
+}
+
+void Tracing::record(const char* name, uint64_t startMicros, uint64_t durationMicros)
+{
+	auto& threadSpans = getThreadSpans();
+	std::unique_lock<std::mutex> lock(threadSpans.mutex);
+	threadSpans.spans[threadSpans.recorded % SpansPerThread] = {name, startMicros, durationMicros};
+	threadSpans.recorded++;
+}
+
+std::string Tracing::toChromeTraceJson(std::size_t maxSpans)
+{
+	struct ExportedSpan
+	{
+		Span span;
+		int threadId;
+	};
+	std::vector<ExportedSpan> exported;
+	{
+		auto& registry = getRegistry();
+		std::unique_lock<std::mutex> lock(registry.mutex);
+		for (auto& threadSpans : registry.threads)
+		{
+			std::unique_lock<std::mutex> threadLock(threadSpans->mutex);
+			auto count = std::min(threadSpans->recorded, SpansPerThread);
+			for (auto i = threadSpans->recorded - count; i < threadSpans->recorded; i++)
+			{
+				exported.push_back({threadSpans->spans[i % SpansPerThread], threadSpans->threadId});
+			}
+		}
+	}
+
+	std::sort(exported.begin(), exported.end(), [](const ExportedSpan& a, const ExportedSpan& b)
+	{
+		return a.span.startMicros < b.span.startMicros;
+	});
+	auto first = exported.begin();
+	if (maxSpans > 0 && exported.size() > maxSpans) first = exported.end() - maxSpans;
+
+	std::string json = "{\"traceEvents\":[";
+	char buffer[96];
+	for (auto iter = first; iter != exported.end(); ++iter)
+	{
+		if (iter != first) json += ',';
+		json += "{\"name\":";
+		appendJsonString(json, iter->span.name);
+		std::snprintf(buffer, sizeof(buffer), ",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":1,\"tid\":%d}",
+					  static_cast<unsigned long long>(iter->span.startMicros),
+					  static_cast<unsigned long long>(iter->span.durationMicros),
+					  iter->threadId);
+		json += buffer;
+	}
+	json += "],\"displayTimeUnit\":\"ms\"}";
+	return json;
+}
+
+bool Tracing::writeChromeTrace(const std::string& path)
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file) return false;
+	file << toChromeTraceJson();
+	return static_cast<bool>(file);
+}
+
+void Tracing::clear()
+{
+	auto& registry = getRegistry();
+	std::unique_lock<std::mutex> lock(registry.mutex);
+	for (auto& threadSpans : registry.threads)
+	{
+		std::unique_lock<std::mutex> threadLock(threadSpans->mutex);
+		threadSpans->recorded = 0;
+	}
+}
+
+TraceScope::TraceScope(const char* name) : name(name), startMicros(ofGetElapsedTimeMicros())
+{
+}
+
+TraceScope::~TraceScope()
+{
+	Tracing::record(name, startMicros, ofGetElapsedTimeMicros() - startMicros);
+}
@@ -0,0 +1,78 @@
+//
+// Scoped trace spans recorded into per-thread ring buffers and exported as Chrome trace events.
+//
+
+#ifndef OFXREMOTEPARAMETERS_TRACING_H
+#define OFXREMOTEPARAMETERS_TRACING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Records the time spent in the enclosing scope under name, which must be a string that outlives the trace,
+ * e.g. a literal. Spans are only recorded when the project defines OFXRP_ENABLE_TRACING (for example with
+ * `PROJECT_DEFINES = OFXRP_ENABLE_TRACING` in config.make). Otherwise the macro expands to nothing.
+ */
+#ifdef OFXRP_ENABLE_TRACING
+#define OFXRP_TRACE_CONCAT_INNER(a, b) a##b
+#define OFXRP_TRACE_CONCAT(a, b) OFXRP_TRACE_CONCAT_INNER(a, b)
+#define OFXRP_TRACE_SCOPE(name) ::ofxRemoteParameters::TraceScope OFXRP_TRACE_CONCAT(ofxrpTraceScope, __LINE__)(name)
+#else
+#define OFXRP_TRACE_SCOPE(name) ((void)0)
+#endif
+
+namespace ofxRemoteParameters
+{
+	namespace Tracing
+	{
+		/// The number of spans kept per thread. Older spans are overwritten.
+		const std::size_t SpansPerThread = 4096;
+
+		/**
+		 * @brief Whether the addon was compiled with OFXRP_ENABLE_TRACING.
+		 */
+		bool isEnabled();
+
+		/**
+		 * @brief Records a span. Called by OFXRP_TRACE_SCOPE, which is easier to use.
+		 */
+		void record(const char* name, uint64_t startMicros, uint64_t durationMicros);
+
+		/**
+		 * @brief Exports the recorded spans of all threads in the Chrome trace event format, which chrome://tracing
+		 * and https://ui.perfetto.dev can open.
+		 * @param maxSpans The maximum number of spans to export, keeping the most recent ones. 0 for all of them.
+		 */
+		std::string toChromeTraceJson(std::size_t maxSpans = 0);
+
+		/**
+		 * @brief Writes toChromeTraceJson() to a file.
+		 * @return false if the file could not be written.
+		 */
+		bool writeChromeTrace(const std::string& path);
+
+		/**
+		 * @brief Discards the spans recorded so far.
+		 */
+		void clear();
+	}
+
+	/**
+	 * @brief Records the lifetime of the object as a span. Use it through OFXRP_TRACE_SCOPE.
+	 */
+	class TraceScope
+	{
+	public:
+		explicit TraceScope(const char* name);
+		~TraceScope();
+		TraceScope(const TraceScope&) = delete;
+		TraceScope& operator=(const TraceScope&) = delete;
+
+	private:
+		const char* name;
+		uint64_t startMicros;
+	};
+}
+
+#endif //OFXREMOTEPARAMETERS_TRACING_H
@@ -0,0 +1,394 @@
+//
+// Binary recording and replay of the OSC traffic received by a Server.
+//
+
+#include "TrafficLog.h"
+#include <cstring>
+
+#ifdef TARGET_WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace ofxRemoteParameters;
+
+namespace
+{
+	const std::string LogModuleName = "ofxRemoteParameters::TrafficLog";
+
+	template<typename T>
+	void put(std::vector<char>& buffer, T value)
+	{
+		auto offset = buffer.size();
+		buffer.resize(offset + sizeof(T));
+		std::memcpy(buffer.data() + offset, &value, sizeof(T));
+	}
+
+	void putBytes(std::vector<char>& buffer, const char* bytes, std::size_t length)
+	{
+		put<uint32_t>(buffer, length);
+		buffer.insert(buffer.end(), bytes, bytes + length);
+	}
+
+	/// position may be past size (e.g. peeking beyond the last record), so it is checked before subtracting
+	template<typename T>
+	bool get(const char* data, std::size_t size, std::size_t& position, T& value)
+	{
+		if (position > size || size - position < sizeof(T)) return false;
+		std::memcpy(&value, data + position, sizeof(T));
+		position += sizeof(T);
+		return true;
+	}
+
+	bool getBytes(const char* data, std::size_t size, std::size_t& position, const char*& bytes, uint32_t& length)
+	{
+		if (!get(data, size, position, length)) return false;
+		if (position > size || size - position < length) return false;
+		bytes = data + position;
+		position += length;
+		return true;
+	}
+}
+
+TrafficRecorder::~TrafficRecorder()
+{
+	close();
+}
+
+bool TrafficRecorder::open(const std::string& path)
+{
+	close();
+	file.open(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		ofLogError(LogModuleName) << "Could not open traffic log for writing: " << path;
+		return false;
+	}
+	recordBuffer.clear();
+	recordBuffer.insert(recordBuffer.end(), TrafficLog::Magic, TrafficLog::Magic + sizeof(TrafficLog::Magic));
+	put<uint16_t>(recordBuffer, TrafficLog::Version);
+	put<uint16_t>(recordBuffer, 0);
+	file.write(recordBuffer.data(), recordBuffer.size());
+	recordCount = 0;
+	return true;
+}
+
+void TrafficRecorder::close()
+{
+	if (file.is_open())
+	{
+		file.close();
+	}
+}
+
+bool TrafficRecorder::isOpen() const
+{
+	return file.is_open();
+}
+
+void TrafficRecorder::record(const ofxOscMessage& message, uint64_t timestampMicros)
+{
+	if (!file.is_open()) return;
+
+	recordBuffer.clear();
+	put<uint32_t>(recordBuffer, 0); // Record size, patched below
+	put<uint64_t>(recordBuffer, timestampMicros);
+	auto& address = message.getAddress();
+	put<uint16_t>(recordBuffer, address.size());
+	recordBuffer.insert(recordBuffer.end(), address.begin(), address.end());
+
+	auto numArgs = message.getNumArgs();
+	put<uint16_t>(recordBuffer, numArgs);
+	for (std::size_t i = 0; i < numArgs; i++)
+	{
+		recordBuffer.push_back(static_cast<char>(message.getArgType(i)));
+	}
+
+	for (std::size_t i = 0; i < numArgs; i++)
+	{
+		switch (message.getArgType(i))
+		{
+			case OFXOSC_TYPE_INT32:
+				put<int32_t>(recordBuffer, message.getArgAsInt32(i));
+				break;
+			case OFXOSC_TYPE_INT64:
+				put<int64_t>(recordBuffer, message.getArgAsInt64(i));
+				break;
+			case OFXOSC_TYPE_FLOAT:
+				put<float>(recordBuffer, message.getArgAsFloat(i));
+				break;
+			case OFXOSC_TYPE_DOUBLE:
+				put<double>(recordBuffer, message.getArgAsDouble(i));
+				break;
+			case OFXOSC_TYPE_STRING:
+			{
+				auto s = message.getArgAsString(i);
+				putBytes(recordBuffer, s.data(), s.size());
+				break;
+			}
+			case OFXOSC_TYPE_SYMBOL:
+			{
+				auto s = message.getArgAsSymbol(i);
+				putBytes(recordBuffer, s.data(), s.size());
+				break;
+			}
+			case OFXOSC_TYPE_BLOB:
+			{
+				auto blob = message.getArgAsBlob(i);
+				putBytes(recordBuffer, blob.getData(), blob.size());
+				break;
+			}
+			case OFXOSC_TYPE_CHAR:
+				put<char>(recordBuffer, message.getArgAsChar(i));
+				break;
+			case OFXOSC_TYPE_MIDI_MESSAGE:
+				put<uint32_t>(recordBuffer, message.getArgAsMidiMessage(i));
+				break;
+			case OFXOSC_TYPE_RGBA_COLOR:
+				put<uint32_t>(recordBuffer, message.getArgAsRgbaColor(i));
+				break;
+			case OFXOSC_TYPE_TIMETAG:
+				put<uint64_t>(recordBuffer, message.getArgAsTimetag(i));
+				break;
+			default:
+				// True, False, None and Trigger carry no payload
+				break;
+		}
+	}
+
+	uint32_t recordSize = recordBuffer.size() - sizeof(uint32_t);
+	std::memcpy(recordBuffer.data(), &recordSize, sizeof(uint32_t));
+	file.write(recordBuffer.data(), recordBuffer.size());
+	recordCount++;
+}
+
+TrafficReplayer::~TrafficReplayer()
+{
+	close();
+}
+
+bool TrafficReplayer::open(const std::string& path)
+{
+	close();
+#ifdef TARGET_WIN32
+	fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+							 FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		fileHandle = nullptr;
+		ofLogError(LogModuleName) << "Could not open traffic log: " << path;
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	GetFileSizeEx(fileHandle, &fileSize);
+	size = static_cast<std::size_t>(fileSize.QuadPart);
+	if (size > 0)
+	{
+		mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mappingHandle)
+		{
+			data = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+		}
+	}
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		ofLogError(LogModuleName) << "Could not open traffic log: " << path;
+		return false;
+	}
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+	{
+		size = static_cast<std::size_t>(fileStat.st_size);
+		void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapped != MAP_FAILED)
+		{
+			data = static_cast<const char*>(mapped);
+			madvise(mapped, size, MADV_SEQUENTIAL);
+		}
+	}
+	// The mapping stays valid after the descriptor is closed
+	::close(fd);
+#endif
+
+	if (!data)
+	{
+		ofLogError(LogModuleName) << "Could not map traffic log: " << path;
+		close();
+		return false;
+	}
+
+	if (size < TrafficLog::HeaderSize || std::memcmp(data, TrafficLog::Magic, sizeof(TrafficLog::Magic)) != 0)
+	{
+		ofLogError(LogModuleName) << "Not a traffic log: " << path;
+		close();
+		return false;
+	}
+
+	uint16_t version;
+	std::memcpy(&version, data + sizeof(TrafficLog::Magic), sizeof(uint16_t));
+	if (version != TrafficLog::Version)
+	{
+		ofLogError(LogModuleName) << "Unsupported traffic log version " << version << ": " << path;
+		close();
+		return false;
+	}
+
+	position = TrafficLog::HeaderSize;
+	return true;
+}
+
+void TrafficReplayer::close()
+{
+#ifdef TARGET_WIN32
+	if (data) UnmapViewOfFile(data);
+	if (mappingHandle) CloseHandle(mappingHandle);
+	if (fileHandle) CloseHandle(fileHandle);
+	mappingHandle = nullptr;
+	fileHandle = nullptr;
+#else
+	if (data) munmap(const_cast<char*>(data), size);
+#endif
+	data = nullptr;
+	size = 0;
+	position = 0;
+}
+
+void TrafficReplayer::rewind()
+{
+	if (data) position = TrafficLog::HeaderSize;
+}
+
+bool TrafficReplayer::peekTimestamp(uint64_t& timestampMicros) const
+{
+	std::size_t p = position + sizeof(uint32_t);
+	return data && get(data, size, p, timestampMicros);
+}
+
+bool TrafficReplayer::next(ofxOscMessage& message, uint64_t& timestampMicros)
+{
+	if (!data || position >= size) return false;
+
+	uint32_t recordSize;
+	std::size_t p = position;
+	if (!get(data, size, p, recordSize) || size - p < recordSize)
+	{
+		ofLogError(LogModuleName) << "Truncated record at offset " << position;
+		position = size;
+		return false;
+	}
+	// Everything below is bounded by the end of this record
+	const std::size_t end = p + recordSize;
+
+	uint16_t addressLength;
+	uint16_t numArgs;
+	bool ok = get(data, end, p, timestampMicros) && get(data, end, p, addressLength) && end - p >= addressLength;
+	if (ok)
+	{
+		message.clear();
+		message.setAddress(std::string(data + p, addressLength));
+		p += addressLength;
+		ok = get(data, end, p, numArgs) && end - p >= numArgs;
+	}
+
+	if (ok)
+	{
+		const char* typeTags = data + p;
+		p += numArgs;
+		for (std::size_t i = 0; ok && i < numArgs; i++)
+		{
+			const char* bytes;
+			uint32_t length;
+			switch (typeTags[i])
+			{
+				case OFXOSC_TYPE_INT32:
+				{
+					int32_t v;
+					if ((ok = get(data, end, p, v))) message.addInt32Arg(v);
+					break;
+				}
+				case OFXOSC_TYPE_INT64:
+				{
+					int64_t v;
+					if ((ok = get(data, end, p, v))) message.addInt64Arg(v);
+					break;
+				}
+				case OFXOSC_TYPE_FLOAT:
+				{
+					float v;
+					if ((ok = get(data, end, p, v))) message.addFloatArg(v);
+					break;
+				}
+				case OFXOSC_TYPE_DOUBLE:
+				{
+					double v;
+					if ((ok = get(data, end, p, v))) message.addDoubleArg(v);
+					break;
+				}
+				case OFXOSC_TYPE_STRING:
+					if ((ok = getBytes(data, end, p, bytes, length))) message.addStringArg(std::string(bytes, length));
+					break;
+				case OFXOSC_TYPE_SYMBOL:
+					if ((ok = getBytes(data, end, p, bytes, length))) message.addSymbolArg(std::string(bytes, length));
+					break;
+				case OFXOSC_TYPE_BLOB:
+					if ((ok = getBytes(data, end, p, bytes, length))) message.addBlobArg(ofBuffer(bytes, length));
+					break;
+				case OFXOSC_TYPE_CHAR:
+				{
+					char v;
+					if ((ok = get(data, end, p, v))) message.addCharArg(v);
+					break;
+				}
+				case OFXOSC_TYPE_MIDI_MESSAGE:
+				{
+					uint32_t v;
+					if ((ok = get(data, end, p, v))) message.addMidiMessageArg(v);
+					break;
+				}
+				case OFXOSC_TYPE_RGBA_COLOR:
+				{
+					uint32_t v;
+					if ((ok = get(data, end, p, v))) message.addRgbaColorArg(v);
+					break;
+				}
+				case OFXOSC_TYPE_TIMETAG:
+				{
+					uint64_t v;
+					if ((ok = get(data, end, p, v))) message.addTimetagArg(v);
+					break;
+				}
+				case OFXOSC_TYPE_TRUE:
+					message.addBoolArg(true);
+					break;
+				case OFXOSC_TYPE_FALSE:
+					message.addBoolArg(false);
+					break;
+				case OFXOSC_TYPE_NONE:
+					message.addNoneArg();
+					break;
+				case OFXOSC_TYPE_TRIGGER:
+					message.addTriggerArg();
+					break;
+				default:
+					ok = false;
+					break;
+			}
+		}
+	}
+
+	if (!ok)
+	{
+		ofLogError(LogModuleName) << "Malformed record at offset " << position;
+		position = size;
+		return false;
+	}
+
+	position = end;
+	return true;
+}
@@ -0,0 +1,105 @@
+//
+// Binary recording and replay of the OSC traffic received by a Server.
+//
+
+#ifndef OFXREMOTEPARAMETERS_TRAFFICLOG_H
+#define OFXREMOTEPARAMETERS_TRAFFICLOG_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "ofxOsc.h"
+
+namespace ofxRemoteParameters
+{
+	/**
+	 * @brief Layout of a traffic log file. All integers are written in host byte order.
+	 *
+	 * Header: 8 byte magic ("OFXRPLOG"), uint16 version, uint16 reserved.
+	 * Each record: uint32 record size (not counting this field), uint64 arrival time in microseconds since the
+	 * recording started, uint16 address length, address bytes, uint16 argument count, one OSC type tag per
+	 * argument and finally the argument payloads. Strings, symbols and blobs are stored as a uint32 length
+	 * followed by their bytes, every other type is stored with its natural size.
+	 */
+	namespace TrafficLog
+	{
+		const char Magic[8] = {'O', 'F', 'X', 'R', 'P', 'L', 'O', 'G'};
+		const uint16_t Version = 1;
+		const std::size_t HeaderSize = sizeof(Magic) + 2 * sizeof(uint16_t);
+	}
+
+	/**
+	 * @brief Appends received OSC messages to a binary traffic log.
+	 */
+	class TrafficRecorder
+	{
+	public:
+		~TrafficRecorder();
+		/**
+		 * @brief Creates (or truncates) the log file at path and writes the header.
+		 * @return false if the file could not be opened.
+		 */
+		bool open(const std::string& path);
+		void close();
+		bool isOpen() const;
+		/**
+		 * @brief Appends a message to the log.
+		 * @param timestampMicros The arrival time of the message, in microseconds since the recording started.
+		 */
+		void record(const ofxOscMessage& message, uint64_t timestampMicros);
+		std::size_t getRecordCount() const { return recordCount; }
+
+	private:
+		std::ofstream file;
+		std::vector<char> recordBuffer;
+		std::size_t recordCount = 0;
+	};
+
+	/**
+	 * @brief Reads a traffic log written by TrafficRecorder. The file is memory-mapped, so reading does not copy
+	 * the log into memory.
+	 */
+	class TrafficReplayer
+	{
+	public:
+		TrafficReplayer() = default;
+		TrafficReplayer(const TrafficReplayer&) = delete;
+		TrafficReplayer& operator=(const TrafficReplayer&) = delete;
+		~TrafficReplayer();
+
+		/**
+		 * @brief Maps the log at path and validates its header.
+		 * @return false if the file could not be mapped or is not a traffic log.
+		 */
+		bool open(const std::string& path);
+		void close();
+		bool isOpen() const { return data != nullptr; }
+
+		/**
+		 * @brief Decodes the next record into message.
+		 * @param timestampMicros Receives the arrival time stored with the record.
+		 * @return false at the end of the log, or if the record is malformed.
+		 */
+		bool next(ofxOscMessage& message, uint64_t& timestampMicros);
+
+		/**
+		 * @brief Returns the arrival time of the next record without consuming it.
+		 * @return false at the end of the log.
+		 */
+		bool peekTimestamp(uint64_t& timestampMicros) const;
+		void rewind();
+		std::size_t getSize() const { return size; }
+		std::size_t getPosition() const { return position; }
+
+	private:
+		const char* data = nullptr;
+		std::size_t size = 0;
+		std::size_t position = 0;
+#ifdef TARGET_WIN32
+		void* fileHandle = nullptr;
+		void* mappingHandle = nullptr;
+#endif
+	};
+}
+
+#endif //OFXREMOTEPARAMETERS_TRAFFICLOG_H
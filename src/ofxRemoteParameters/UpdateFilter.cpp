@@ -0,0 +1,134 @@
+//
+// Deadband, quantization and rate limiting of outbound value updates.
+//
+
+#include "UpdateFilter.h"
+
+using namespace ofxRemoteParameters;
+
+bool ofxRemoteParameters::matchesPathPattern(const std::string& pattern, const std::string& text)
+{
+	std::size_t p = 0;
+	std::size_t t = 0;
+	std::size_t starPattern = std::string::npos;
+	std::size_t starText = 0;
+	while (t < text.size())
+	{
+		if (p < pattern.size() && pattern[p] == '*')
+		{
+			starPattern = p++;
+			starText = t;
+		}
+		else if (p < pattern.size() && pattern[p] == text[t])
+		{
+			p++;
+			t++;
+		}
+		else if (starPattern != std::string::npos)
+		{
+			// Let the last star absorb one more character and try again
+			p = starPattern + 1;
+			t = ++starText;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	while (p < pattern.size() && pattern[p] == '*') p++;
+	return p == pattern.size();
+}
+
+void UpdateFilterSet::setPathFilter(const std::string& pattern, const UpdateFilter& filter)
+{
+	for (auto& pathFilter : pathFilters)
+	{
+		if (pathFilter.first == pattern)
+		{
+			pathFilter.second = filter;
+			return;
+		}
+	}
+	pathFilters.emplace_back(pattern, filter);
+}
+
+const UpdateFilter* UpdateFilterSet::findPathFilter(const std::string& path) const
+{
+	for (auto& pathFilter : pathFilters)
+	{
+		if (matchesPathPattern(pathFilter.first, path)) return &pathFilter.second;
+	}
+	return nullptr;
+}
+
+bool UpdateFilterSet::filterString(const std::string& path,
+								   const UpdateFilter& filter,
+								   const std::string& serialized,
+								   uint64_t nowMicros)
+{
+	components.clear();
+	return filterSerialized(path, filter, false, serialized, nowMicros);
+}
+
+bool UpdateFilterSet::filterSerialized(const std::string& path,
+									   const UpdateFilter& filter,
+									   bool isNumeric,
+									   const std::string& serialized,
+									   uint64_t nowMicros)
+{
+	auto& state = states[path];
+	state.minIntervalMicros = filter.maxRate > 0 ? static_cast<uint64_t>(1000000.0 / filter.maxRate) : 0;
+
+	bool isSignificant;
+	if (!state.hasSent)
+	{
+		isSignificant = true;
+	}
+	else if (isNumeric && components.size() == state.lastSentComponents.size())
+	{
+		double largestChange = 0;
+		for (std::size_t i = 0; i < components.size(); i++)
+		{
+			largestChange = std::max(largestChange, std::abs(components[i] - state.lastSentComponents[i]));
+		}
+		isSignificant = largestChange > 0 && largestChange >= filter.deadband;
+	}
+	else
+	{
+		isSignificant = serialized != state.lastSent;
+	}
+
+	if (!isSignificant)
+	{
+		// The value came back close to the one the other end has, so there is nothing left to send:
+		state.hasPending = false;
+		return false;
+	}
+
+	if (state.hasSent && nowMicros - state.lastSentMicros < state.minIntervalMicros)
+	{
+		if (!state.hasPending) pendingPaths.push_back(path);
+		state.hasPending = true;
+		state.pendingValue = serialized;
+		state.pendingComponents = components;
+		return false;
+	}
+
+	state.hasSent = true;
+	state.hasPending = false;
+	state.lastSent = serialized;
+	state.lastSentComponents = components;
+	state.lastSentMicros = nowMicros;
+	return true;
+}
+
+void UpdateFilterSet::forget(const std::string& path)
+{
+	states.erase(path);
+}
+
+void UpdateFilterSet::clear()
+{
+	states.clear();
+	pendingPaths.clear();
+}
@@ -0,0 +1,202 @@
+//
+// Deadband, quantization and rate limiting of outbound value updates.
+//
+
+#ifndef OFXREMOTEPARAMETERS_UPDATEFILTER_H
+#define OFXREMOTEPARAMETERS_UPDATEFILTER_H
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "ofColor.h"
+#include "ofUtils.h"
+#include "ofVectorMath.h"
+#include "ParameterTypes.h"
+
+namespace ofxRemoteParameters
+{
+	/**
+	 * @brief Decides which changes of a parameter are significant enough to be sent. Deadband and quantization apply
+	 * to the numeric types (int, float, double, the glm vectors and the colors), the maximum rate to every type.
+	 */
+	struct UpdateFilter
+	{
+		/// Changes are only sent when a component of the value moved by at least this much since the last value sent.
+		double deadband = 0;
+		/// Values are rounded to multiples of this before being compared and sent. 0 disables quantization.
+		double quantization = 0;
+		/// The maximum number of updates per second, or 0 for no limit. The last value held back by the limit is
+		/// sent as soon as the limit allows it.
+		double maxRate = 0;
+
+		bool isActive() const
+		{
+			return deadband > 0 || quantization > 0 || maxRate > 0;
+		}
+	};
+
+	namespace priv
+	{
+		template<typename Scalar>
+		Scalar quantizeComponent(Scalar value, double step)
+		{
+			if (step <= 0) return value;
+			return static_cast<Scalar>(std::round(value / step) * step);
+		}
+
+		/**
+		 * @brief Quantizes value in place and appends its components.
+		 * @return false if T is not a numeric type.
+		 */
+		template<typename T>
+		bool quantizeValue(T& value, double step, std::vector<double>& components)
+		{
+			if constexpr (std::is_arithmetic<T>::value && !std::is_same<T, bool>::value)
+			{
+				value = quantizeComponent(value, step);
+				components.push_back(value);
+				return true;
+			}
+			else if constexpr (std::is_same<T, glm::vec2>::value ||
+							   std::is_same<T, glm::vec3>::value ||
+							   std::is_same<T, glm::vec4>::value)
+			{
+				for (int i = 0; i < value.length(); i++)
+				{
+					value[i] = quantizeComponent(value[i], step);
+					components.push_back(value[i]);
+				}
+				return true;
+			}
+			else if constexpr (std::is_same<T, ofColor>::value ||
+							   std::is_same<T, ofShortColor>::value ||
+							   std::is_same<T, ofFloatColor>::value)
+			{
+				for (int i = 0; i < 4; i++)
+				{
+					value[i] = quantizeComponent(value[i], step);
+					components.push_back(value[i]);
+				}
+				return true;
+			}
+			else
+			{
+				return false;
+			}
+		}
+	}
+
+	/**
+	 * @brief Matches text against a pattern where `*` stands for any sequence of characters, like the path patterns of
+	 * UpdateFilterSet::setPathFilter().
+	 */
+	bool matchesPathPattern(const std::string& pattern, const std::string& text);
+
+	/**
+	 * @brief Holds the UpdateFilter registered for path patterns, and the last value sent for each filtered parameter.
+	 */
+	class UpdateFilterSet
+	{
+	public:
+		/**
+		 * @brief Sets the filter for the parameters whose path matches pattern. `*` matches any sequence of
+		 * characters, so "/Root/Sensors*" matches every parameter in the Sensors group. Patterns are matched in the
+		 * order they were added, and setting an existing pattern replaces its filter.
+		 */
+		void setPathFilter(const std::string& pattern, const UpdateFilter& filter);
+		/**
+		 * @return The filter of the first pattern that matches path, or nullptr.
+		 */
+		const UpdateFilter* findPathFilter(const std::string& path) const;
+
+		/**
+		 * @brief Quantizes value and checks whether it is significantly different from the last value sent for path.
+		 * @param serialized Receives the quantized value as a string.
+		 * @return true if the value should be sent now. Values held back by the maximum rate are returned by flush()
+		 * later on.
+		 */
+		template<typename T>
+		bool filterValue(const std::string& path,
+						 const UpdateFilter& filter,
+						 T value,
+						 std::string& serialized,
+						 uint64_t nowMicros)
+		{
+			components.clear();
+			bool isNumeric = priv::quantizeValue(value, filter.quantization, components);
+			serialized = valueToString(value);
+			return filterSerialized(path, filter, isNumeric, serialized, nowMicros);
+		}
+
+		/**
+		 * @brief Same as filterValue() for values that are only available as strings. Only the maximum rate applies,
+		 * and values that didn't change are not sent.
+		 */
+		bool filterString(const std::string& path, const UpdateFilter& filter, const std::string& serialized,
+						  uint64_t nowMicros);
+
+		/**
+		 * @brief Calls send(path, value) for every value held back by the maximum rate that can now be sent.
+		 */
+		template<typename Function>
+		void flush(uint64_t nowMicros, Function&& send)
+		{
+			if (pendingPaths.empty()) return;
+			std::size_t kept = 0;
+			for (std::size_t i = 0; i < pendingPaths.size(); i++)
+			{
+				auto iter = states.find(pendingPaths[i]);
+				if (iter == states.end() || !iter->second.hasPending) continue;
+				auto& state = iter->second;
+				if (nowMicros - state.lastSentMicros < state.minIntervalMicros)
+				{
+					pendingPaths[kept++] = std::move(pendingPaths[i]);
+					continue;
+				}
+				state.hasPending = false;
+				state.lastSentMicros = nowMicros;
+				state.lastSent = state.pendingValue;
+				state.lastSentComponents.swap(state.pendingComponents);
+				send(iter->first, state.lastSent);
+			}
+			pendingPaths.resize(kept);
+		}
+
+		/**
+		 * @brief Forgets the last value sent for path, so that the next change is sent whatever its size. Call this
+		 * when the value at the other end changed without going through the filter.
+		 */
+		void forget(const std::string& path);
+		void clear();
+
+	private:
+		struct State
+		{
+			std::string lastSent;
+			std::vector<double> lastSentComponents;
+			uint64_t lastSentMicros = 0;
+			uint64_t minIntervalMicros = 0;
+			bool hasSent = false;
+			bool hasPending = false;
+			std::string pendingValue;
+			std::vector<double> pendingComponents;
+		};
+
+		bool filterSerialized(const std::string& path,
+							  const UpdateFilter& filter,
+							  bool isNumeric,
+							  const std::string& serialized,
+							  uint64_t nowMicros);
+
+		std::vector<std::pair<std::string, UpdateFilter>> pathFilters;
+		std::unordered_map<std::string, State> states;
+		std::vector<std::string> pendingPaths;
+		std::vector<double> components;
+	};
+}
+
+#endif //OFXREMOTEPARAMETERS_UPDATEFILTER_H
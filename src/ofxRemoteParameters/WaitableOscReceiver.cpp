@@ -0,0 +1,27 @@
+//
+// An ofxOscReceiver that lets a thread sleep until a message arrives.
+//
+
+#include "WaitableOscReceiver.h"
+#include <chrono>
+
+using namespace ofxRemoteParameters;
+
+bool WaitableOscReceiver::waitForMessage(uint64_t timeoutMillis)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	return messageReceived.wait_for(lock, std::chrono::milliseconds(timeoutMillis), [this]()
+	{
+		return hasWaitingMessages();
+	});
+}
+
+void WaitableOscReceiver::ProcessMessage(const osc::ReceivedMessage& message, const IpEndpointName& remoteEndpoint)
+{
+	ofxOscReceiver::ProcessMessage(message, remoteEndpoint);
+	// Taking the lock orders the message before a waiter that has just found the queue empty goes to sleep:
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+	}
+	messageReceived.notify_all();
+}
@@ -0,0 +1,38 @@
+//
+// An ofxOscReceiver that lets a thread sleep until a message arrives.
+//
+
+#ifndef OFXREMOTEPARAMETERS_WAITABLEOSCRECEIVER_H
+#define OFXREMOTEPARAMETERS_WAITABLEOSCRECEIVER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include "ofxOsc.h"
+
+namespace ofxRemoteParameters
+{
+	/**
+	 * @brief ofxOscReceiver already receives on its own thread, but it can only be polled with
+	 * hasWaitingMessages(). This receiver also signals every message, so that a Client without a render loop can
+	 * block until there is something to do instead of spinning.
+	 */
+	class WaitableOscReceiver : public ofxOscReceiver
+	{
+	public:
+		/**
+		 * @brief Blocks until a message is waiting or timeoutMillis have passed.
+		 * @return true if a message is waiting.
+		 */
+		bool waitForMessage(uint64_t timeoutMillis);
+
+	protected:
+		void ProcessMessage(const osc::ReceivedMessage& message, const IpEndpointName& remoteEndpoint) override;
+
+	private:
+		std::mutex mutex;
+		std::condition_variable messageReceived;
+	};
+}
+
+#endif //OFXREMOTEPARAMETERS_WAITABLEOSCRECEIVER_H
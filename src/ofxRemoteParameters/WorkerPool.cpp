@@ -0,0 +1,75 @@
+//
+// A fixed set of threads that run the same work together.
+//
+
+#include "WorkerPool.h"
+
+using namespace ofxRemoteParameters;
+
+WorkerPool::~WorkerPool()
+{
+	stop();
+}
+
+void WorkerPool::start(std::size_t count)
+{
+	stop();
+	for (std::size_t i = 0; i < count; i++)
+	{
+		// The threads start from the current generation, so that they don't miss a run() that comes before they wait:
+		threads.emplace_back(&WorkerPool::loop, this, generation);
+	}
+}
+
+void WorkerPool::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	workAvailable.notify_all();
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+	threads.clear();
+	stopping = false;
+}
+
+void WorkerPool::run(const std::function<void()>& work)
+{
+	if (threads.empty())
+	{
+		work();
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->work = &work;
+		busyThreads = threads.size();
+		generation++;
+	}
+	workAvailable.notify_all();
+	work();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	workDone.wait(lock, [this]() { return busyThreads == 0; });
+	this->work = nullptr;
+}
+
+void WorkerPool::loop(uint64_t lastGeneration)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true)
+	{
+		workAvailable.wait(lock, [&]() { return stopping || generation != lastGeneration; });
+		if (stopping) return;
+		lastGeneration = generation;
+		auto& currentWork = *work;
+		lock.unlock();
+		currentWork();
+		lock.lock();
+		if (--busyThreads == 0) workDone.notify_one();
+	}
+}
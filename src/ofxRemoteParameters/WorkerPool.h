@@ -0,0 +1,59 @@
+//
+// A fixed set of threads that run the same work together.
+//
+
+#ifndef OFXREMOTEPARAMETERS_WORKERPOOL_H
+#define OFXREMOTEPARAMETERS_WORKERPOOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ofxRemoteParameters
+{
+	/**
+	 * @brief Threads that are started once and then sleep until run() gives them work, so that running work in
+	 * parallel doesn't pay for starting and joining threads every time.
+	 */
+	class WorkerPool
+	{
+	public:
+		WorkerPool() = default;
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+		~WorkerPool();
+
+		/**
+		 * @brief Stops the current threads, if any, and starts count new ones.
+		 */
+		void start(std::size_t count);
+		void stop();
+		std::size_t size() const { return threads.size(); }
+
+		/**
+		 * @brief Calls work on every thread of the pool and on the calling thread, and returns once all the calls
+		 * have returned. work is typically a loop that takes tasks from a shared counter until there are none left.
+		 * Must not be called from several threads at once.
+		 */
+		void run(const std::function<void()>& work);
+
+	private:
+		void loop(uint64_t generation);
+
+		std::vector<std::thread> threads;
+		std::mutex mutex;
+		std::condition_variable workAvailable;
+		std::condition_variable workDone;
+		const std::function<void()>* work = nullptr;
+		/// Incremented by run(), so that each thread calls the work of a run once
+		uint64_t generation = 0;
+		/// The threads that haven't finished the current work
+		std::size_t busyThreads = 0;
+		bool stopping = false;
+	};
+}
+
+#endif //OFXREMOTEPARAMETERS_WORKERPOOL_H
@@ -0,0 +1,176 @@
+//
+// Streaming XML text writer.
+//
+
+#ifndef OFXREMOTEPARAMETERS_XMLWRITER_H
+#define OFXREMOTEPARAMETERS_XMLWRITER_H
+
+#include <string>
+#include <vector>
+
+namespace ofxRemoteParameters
+{
+	/**
+	 * @brief Writes XML text directly into a string, without building a DOM. The output is formatted like
+	 * ofXml::toString() (pugixml's default format, tab indentation), so a model written with XmlWriter is the same
+	 * text as one built with ofXml.
+	 */
+	class XmlWriter
+	{
+	public:
+		void clear()
+		{
+			buffer.clear();
+			openElements.clear();
+			startTagOpen = false;
+			baseDepth = 0;
+		}
+
+		/**
+		 * @brief Indents as if the output was nested in depth elements, to write a fragment that will be inserted
+		 * into another document with appendFragment().
+		 */
+		void setBaseDepth(std::size_t depth)
+		{
+			baseDepth = depth;
+		}
+
+		/**
+		 * @brief Inserts a fragment written by another XmlWriter as a child of the currently open element. The other
+		 * writer should have had its base depth set to getDepth() of this one.
+		 */
+		void appendFragment(const std::string& fragment)
+		{
+			// An empty fragment leaves an element with no other children self-closing
+			if (fragment.empty()) return;
+			finishStartTag();
+			buffer += fragment;
+		}
+
+		void reserve(std::size_t size)
+		{
+			buffer.reserve(size);
+		}
+
+		/**
+		 * @brief Starts a new element as a child of the currently open one. Attributes can be added until the next
+		 * child element is started.
+		 */
+		void openElement(const std::string& name)
+		{
+			finishStartTag();
+			indent();
+			buffer += '<';
+			buffer += name;
+			openElements.push_back(name);
+			startTagOpen = true;
+		}
+
+		void attribute(const std::string& name, const std::string& value)
+		{
+			buffer += ' ';
+			buffer += name;
+			buffer += "=\"";
+			escape(value, true);
+			buffer += '"';
+		}
+
+		/**
+		 * @brief Writes a child element that only contains text, i.e. <name>text</name>
+		 */
+		void textElement(const std::string& name, const std::string& text)
+		{
+			finishStartTag();
+			indent();
+			buffer += '<';
+			buffer += name;
+			buffer += '>';
+			escape(text, false);
+			buffer += "</";
+			buffer += name;
+			buffer += ">\n";
+		}
+
+		void closeElement()
+		{
+			if (startTagOpen)
+			{
+				buffer += " />\n";
+				startTagOpen = false;
+				openElements.pop_back();
+				return;
+			}
+			std::string name = std::move(openElements.back());
+			openElements.pop_back();
+			indent();
+			buffer += "</";
+			buffer += name;
+			buffer += ">\n";
+		}
+
+		const std::string& getString() const { return buffer; }
+		std::string& getString() { return buffer; }
+		std::size_t getDepth() const { return baseDepth + openElements.size(); }
+
+	private:
+		void finishStartTag()
+		{
+			if (startTagOpen)
+			{
+				buffer += ">\n";
+				startTagOpen = false;
+			}
+		}
+
+		void indent()
+		{
+			buffer.append(baseDepth + openElements.size(), '\t');
+		}
+
+		/**
+		 * @brief Escapes the way pugixml does: &, < and control characters everywhere, > in text, and " as well as
+		 * tabs and line breaks in attributes.
+		 */
+		void escape(const std::string& s, bool isAttribute)
+		{
+			for (char c : s)
+			{
+				switch (c)
+				{
+					case '&': buffer += "&amp;"; break;
+					case '<': buffer += "&lt;"; break;
+					case '>':
+						if (isAttribute) buffer += c;
+						else buffer += "&gt;";
+						break;
+					case '"':
+						if (isAttribute) buffer += "&quot;";
+						else buffer += c;
+						break;
+					default:
+					{
+						auto ch = static_cast<unsigned char>(c);
+						if (ch < 32 && (isAttribute || (c != '\t' && c != '\n' && c != '\r')))
+						{
+							buffer += "&#";
+							buffer += static_cast<char>('0' + ch / 10);
+							buffer += static_cast<char>('0' + ch % 10);
+							buffer += ';';
+						}
+						else
+						{
+							buffer += c;
+						}
+					}
+				}
+			}
+		}
+
+		std::string buffer;
+		std::vector<std::string> openElements;
+		bool startTagOpen = false;
+		std::size_t baseDepth = 0;
+	};
+}
+
+#endif //OFXREMOTEPARAMETERS_XMLWRITER_H